@@ -1,66 +1,48 @@
+#pragma once
+
+#include "builtins.h"
+#include "bytecode.h"
 #include "parser.h"
-#include <unordered_map>
 
-typedef AST (*Functor)(std::shared_ptr<Cell>);
+#include <vector>
 
+// Reference evaluator: walks the AST, evaluating each call through the same
+// builtin table as the virtual machine.
 class Applier {
 public:
     Applier() = delete;
     ~Applier() = delete;
 
-    static Functor GetFunctor(const std::string& arg);
+    // The builtin named `name`, throws RuntimeError if there is none.
+    static const Builtin* Resolve(const std::string& name);
 
-    static AST Apply(AST ast);
+    // The calls being evaluated are kept on an explicit stack, so nesting
+    // costs no native stack; calls nested deeper than max_depth raise
+    // RuntimeError, as in the VM.
+    static AST Apply(const AST& ast, size_t max_depth = kDefaultMaxDepth);
 
 private:
-    class QuoteOperations {
-    public:
-        static AST OpQuote(std::shared_ptr<Quote> ast);
-    };
-
-    class IntegerOperations {
-    public:
-        static AST OpIsNumber(std::shared_ptr<Cell> ast);
-
-        static AST OpPlus(std::shared_ptr<Cell> ast);
-        static AST OpMinus(std::shared_ptr<Cell> ast);
-        static AST OpMultiply(std::shared_ptr<Cell> ast);
-        static AST OpDivide(std::shared_ptr<Cell> ast);
-
-        static AST OpEqual(std::shared_ptr<Cell> ast);
-        static AST OpLess(std::shared_ptr<Cell> ast);
-        static AST OpGreater(std::shared_ptr<Cell> ast);
-        static AST OpLessEqual(std::shared_ptr<Cell> ast);
-        static AST OpGreaterEqual(std::shared_ptr<Cell> ast);
-
-        static AST OpMin(std::shared_ptr<Cell> ast);
-        static AST OpMax(std::shared_ptr<Cell> ast);
-
-        static AST OpAbs(std::shared_ptr<Cell> ast);
-    };
-
-    class BooleanOperations {
-    public:
-        static AST OpIsBoolean(std::shared_ptr<Cell> ast);
-        static AST OpNot(std::shared_ptr<Cell> ast);
-        static AST OpAnd(std::shared_ptr<Cell> ast);
-        static AST OpOr(std::shared_ptr<Cell> ast);
+    // A call being evaluated: its operator until `builtin` is known, then its
+    // operands one by one.
+    struct Frame {
+        const Builtin* builtin;
+        // The operands after the one being evaluated.
+        const AST* rest;
+        // Where the evaluated arguments of an eager call start in `values`.
+        size_t start;
+        // The last operand of a comparison, or the value and / or returns
+        // if no operand stops it.
+        AST last;
     };
 
-    class ListOperations {
-    public:
-        static AST OpIsList(std::shared_ptr<Cell> ast);
-        static AST OpIsPair(std::shared_ptr<Cell> ast);
-        static AST OpIsNull(std::shared_ptr<Cell> ast);
-
-        static AST OpList(std::shared_ptr<Cell> ast);
-        static AST OpListRef(std::shared_ptr<Cell> ast);
-        static AST OpListTail(std::shared_ptr<Cell> ast);
-
-        static AST OpCons(std::shared_ptr<Cell> ast);
-        static AST OpCdr(std::shared_ptr<Cell> ast);
-        static AST OpCar(std::shared_ptr<Cell> ast);
-    };
+    // Each takes the value just evaluated for the innermost call and returns
+    // the next operand to evaluate, or null once the call is complete and
+    // `value` holds its result.
+    static const AST* Start(Frame* frame, AST* value);
+    static const AST* Resume(Frame* frame, AST* value);
+    static const AST* Next(Frame* frame, AST* value);
 
-    static std::unordered_map<std::string, Functor> functors;
+    // Shared by every Apply of a thread, each one works above what it found.
+    static thread_local std::vector<Frame> frames;
+    static thread_local std::vector<AST> values;
 };
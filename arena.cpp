@@ -0,0 +1,58 @@
+#include "arena.h"
+
+thread_local Arena* Arena::current = nullptr;
+
+Arena::Arena(size_t block_size) : block_size_(block_size) {
+}
+
+void* Arena::Allocate(size_t size) {
+    size = (size + kAlignment - 1) & ~(kAlignment - 1);
+    if (size > block_size_) {
+        large_blocks_.push_back(std::make_unique<std::byte[]>(size));
+        large_bytes_ += size;
+        bytes_allocated_ += size;
+        return large_blocks_.back().get();
+    }
+    if (blocks_.empty() || offset_ + size > block_size_) {
+        if (!blocks_.empty()) {
+            ++block_index_;
+        }
+        if (block_index_ == blocks_.size()) {
+            blocks_.push_back(std::make_unique<std::byte[]>(block_size_));
+        }
+        offset_ = 0;
+    }
+    void* ptr = blocks_[block_index_].get() + offset_;
+    offset_ += size;
+    bytes_allocated_ += size;
+    return ptr;
+}
+
+void Arena::Reset() {
+    block_index_ = 0;
+    offset_ = 0;
+    bytes_allocated_ = 0;
+    large_blocks_.clear();
+    large_bytes_ = 0;
+}
+
+size_t Arena::GetBlockSize() const {
+    return block_size_;
+}
+
+size_t Arena::GetBytesAllocated() const {
+    return bytes_allocated_;
+}
+
+size_t Arena::GetBytesReserved() const {
+    return blocks_.size() * block_size_ + large_bytes_;
+}
+
+ArenaScope::ArenaScope(Arena* arena) : arena_(arena), previous_(Arena::current) {
+    Arena::current = arena_;
+}
+
+ArenaScope::~ArenaScope() {
+    Arena::current = previous_;
+    arena_->Reset();
+}
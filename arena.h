@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// Bump-pointer allocator for the objects of one request. Objects taken from
+// an arena are referenced by unmanaged Values: they are never counted or
+// destroyed one by one, Reset() drops all of them at once. Their children
+// are not released either, so an arena object must only point to other
+// arena objects, immediates or interned symbols.
+class Arena {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    Arena(size_t block_size = kDefaultBlockSize);
+
+    Arena(const Arena&) = delete;
+    Arena& operator=(const Arena&) = delete;
+
+    // A size above the block size gets a block of its own.
+    void* Allocate(size_t size);
+
+    // Forgets every allocation, the blocks are kept for reuse.
+    void Reset();
+
+    size_t GetBlockSize() const;
+    size_t GetBytesAllocated() const;
+    size_t GetBytesReserved() const;
+
+    // The arena MakeCell and friends allocate from on this thread, if any.
+    static Arena* Current() {
+        return current;
+    }
+
+private:
+    friend class ArenaScope;
+
+    static constexpr size_t kAlignment = alignof(std::max_align_t);
+
+    static thread_local Arena* current;
+
+    size_t block_size_;
+    std::vector<std::unique_ptr<std::byte[]>> blocks_;
+    size_t block_index_ = 0;
+    size_t offset_ = 0;
+    size_t bytes_allocated_ = 0;
+    // Oversized allocations, released by Reset() rather than kept.
+    std::vector<std::unique_ptr<std::byte[]>> large_blocks_;
+    size_t large_bytes_ = 0;
+};
+
+// Routes the allocations of the current thread to `arena` and resets it when
+// the scope ends; every Value pointing into the arena must be dead by then.
+class ArenaScope {
+public:
+    explicit ArenaScope(Arena* arena);
+    ~ArenaScope();
+
+    ArenaScope(const ArenaScope&) = delete;
+    ArenaScope& operator=(const ArenaScope&) = delete;
+
+private:
+    Arena* arena_;
+    Arena* previous_;
+};
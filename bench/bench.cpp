@@ -0,0 +1,49 @@
+#include "bench.h"
+
+#include <chrono>
+
+static constexpr double kMinRunSeconds = 0.2;
+static constexpr size_t kMaxIterations = size_t{1} << 32;
+
+struct Benchmark {
+    std::string name;
+    BenchmarkBody body;
+    size_t bytes_per_iteration;
+};
+
+static std::vector<Benchmark>& Registry() {
+    static std::vector<Benchmark> registry;
+    return registry;
+}
+
+BenchmarkRegistration::BenchmarkRegistration(std::string name, BenchmarkBody body,
+                                             size_t bytes_per_iteration) {
+    Registry().push_back({std::move(name), std::move(body), bytes_per_iteration});
+}
+
+static double TimeRun(const BenchmarkBody& body, size_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+    body(iterations);
+    std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+    return elapsed.count();
+}
+
+std::vector<BenchmarkResult> RunBenchmarks(const std::string& filter) {
+    std::vector<BenchmarkResult> results;
+    for (const auto& [name, body, bytes_per_iteration] : Registry()) {
+        if (name.find(filter) == std::string::npos) {
+            continue;
+        }
+        // Untimed, so that inputs a body builds on first use are not measured.
+        body(1);
+        size_t iterations = 1;
+        double seconds = TimeRun(body, iterations);
+        while (seconds < kMinRunSeconds && iterations < kMaxIterations) {
+            iterations *= (seconds * 10 < kMinRunSeconds) ? 10 : 2;
+            seconds = TimeRun(body, iterations);
+        }
+        double megabytes = static_cast<double>(bytes_per_iteration) * iterations / 1e6;
+        results.push_back({name, iterations, seconds * 1e9 / iterations, megabytes / seconds});
+    }
+    return results;
+}
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+// Minimal harness for scheme_bench. A benchmark body performs the measured
+// operation `iterations` times; the harness grows the iteration count until
+// one run is long enough to be timed reliably.
+
+using BenchmarkBody = std::function<void(size_t iterations)>;
+
+struct BenchmarkResult {
+    std::string name;
+    size_t iterations;
+    double ns_per_iteration;
+    // Zero unless the benchmark declared how much input one iteration consumes.
+    double megabytes_per_second = 0;
+};
+
+struct BenchmarkRegistration {
+    // A non-zero bytes_per_iteration makes the result report throughput.
+    BenchmarkRegistration(std::string name, BenchmarkBody body, size_t bytes_per_iteration = 0);
+};
+
+std::vector<BenchmarkResult> RunBenchmarks(const std::string& filter);
+
+template <class T>
+void DoNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
@@ -0,0 +1,34 @@
+#include "bench.h"
+
+#include "scheme.h"
+
+namespace {
+
+std::string MakeQuotedList(size_t length) {
+    std::string list = "'(";
+    for (size_t i = 0; i < length; ++i) {
+        list += std::to_string(i * 7919) + " (a " + std::to_string(i) + ") ";
+    }
+    return list + ")";
+}
+
+int RegisterAll() {
+    for (size_t length : {100, 10000}) {
+        for (bool use_arena : {false, true}) {
+            std::string name = std::string("arena/run/") + (use_arena ? "arena" : "heap") +
+                               "/quoted_list_" + std::to_string(length);
+            BenchmarkRegistration(name, [use_arena, length](size_t iterations) {
+                std::string expr = MakeQuotedList(length);
+                Interpreter interpreter({.use_arena = use_arena});
+                for (size_t i = 0; i < iterations; ++i) {
+                    DoNotOptimize(interpreter.Run(expr));
+                }
+            });
+        }
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
@@ -0,0 +1,58 @@
+#include "bench.h"
+
+#include "scheme.h"
+
+#include <thread>
+
+namespace {
+
+constexpr size_t kBatchSize = 10000;
+
+std::vector<std::string> MakeBatch() {
+    static const std::vector<std::string> kTemplates = {
+        "(max (+ 1 (* 2 3)) (- 10 4) (abs -7) (min 8 (/ 81 9)))",
+        "(and (< 1 2 3) (or #f (= 4 4)) (not #f) (>= 5 5 1))",
+        "(list-ref (cons 0 '(1 2 3 4 5 6 7 8 9)) 7)",
+        "'(1 2 3 4 5 6 7 8 (9 10) (11 12))",
+        "(car '())",
+    };
+    std::vector<std::string> batch;
+    for (size_t i = 0; i < kBatchSize; ++i) {
+        batch.push_back(kTemplates[i % kTemplates.size()]);
+    }
+    return batch;
+}
+
+int RegisterAll() {
+    BenchmarkRegistration("batch/sequential", [](size_t iterations) {
+        std::vector<std::string> batch = MakeBatch();
+        Interpreter interpreter;
+        for (size_t i = 0; i < iterations; ++i) {
+            for (const auto& expr : batch) {
+                try {
+                    DoNotOptimize(interpreter.Run(expr));
+                } catch (const RuntimeError&) {
+                }
+            }
+        }
+    });
+
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+        BenchmarkRegistration("batch/threads_" + std::to_string(threads), [threads](size_t iterations) {
+            std::vector<std::string> batch = MakeBatch();
+            Interpreter interpreter({.batch_threads = threads});
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(interpreter.RunBatch(batch));
+            }
+        });
+        if (threads == max_threads) {
+            break;
+        }
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
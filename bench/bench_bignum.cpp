@@ -0,0 +1,84 @@
+#include "bench.h"
+
+#include "big_integer.h"
+#include "scheme.h"
+#include "vm.h"
+
+#include <random>
+
+namespace {
+
+BigInteger MakeRandom(size_t limbs, uint32_t seed) {
+    std::mt19937 random(seed);
+    std::vector<uint32_t> digits(limbs);
+    for (uint32_t& digit : digits) {
+        digit = random();
+    }
+    digits.back() |= 1;
+    return BigInteger::FromLimbs(false, digits);
+}
+
+// Calls that leave the fixnum range, from literals, through both the VM and
+// the kernels it falls back to.
+const std::vector<std::pair<std::string, std::string>> kPromotions = {
+    {"add", "(+ 9223372036854775807 1)"},
+    {"mul", "(* 4611686018427387903 4611686018427387903)"},
+    {"div", "(/ 85070591730234615847396907784232501249 9223372036854775807)"},
+    {"compare", "(< 1 99999999999999999999 199999999999999999999)"},
+};
+
+int RegisterAll() {
+    // Operands of n limbs, 32n bits; division takes a 2n by n limb quotient.
+    for (size_t limbs : {2, 8, 64}) {
+        std::string size = std::to_string(limbs);
+        BigInteger lhs = MakeRandom(limbs, 1);
+        BigInteger rhs = MakeRandom(limbs, 2);
+        BigInteger wide = lhs * rhs;
+        BenchmarkRegistration("bignum/add/" + size, [lhs, rhs](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(lhs + rhs);
+            }
+        });
+        BenchmarkRegistration("bignum/mul/" + size, [lhs, rhs](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(lhs * rhs);
+            }
+        });
+        BenchmarkRegistration("bignum/div/" + size, [wide, rhs](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(wide / rhs);
+            }
+        });
+        BenchmarkRegistration("bignum/compare/" + size, [lhs, rhs](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(Compare(lhs, rhs));
+            }
+        });
+        BenchmarkRegistration("bignum/print/" + size, [lhs](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(lhs.ToString());
+            }
+        });
+        std::string digits = lhs.ToString();
+        BenchmarkRegistration("bignum/parse/" + size, [digits](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(BigInteger::FromDecimal(digits));
+            }
+        });
+    }
+    for (const auto& [name, expr] : kPromotions) {
+        BenchmarkRegistration("bignum/promote/" + name, [expr](size_t iterations) {
+            Tokenizer tokenizer{std::string_view(expr)};
+            Program program = Compile(Read(&tokenizer));
+            VirtualMachine vm;
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(vm.Run(program));
+            }
+        });
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
@@ -0,0 +1,77 @@
+#include "bench.h"
+
+#include "binary_ast.h"
+
+#include <map>
+#include <string>
+
+namespace {
+
+// Quoted data of every node kind, roughly `size` bytes of text in all.
+std::string MakeDataSet(size_t size) {
+    std::string text;
+    for (size_t i = 0; text.size() < size; ++i) {
+        text += "'(record-" + std::to_string(i % 97) + " " + std::to_string(i * 7919) +
+                " (#t #f -" + std::to_string(i) + ") (key . value) 123456789012345678901234)\n";
+    }
+    return text;
+}
+
+// The data set of each size as text and binary, made on first use: the
+// largest takes a while to build and most runs filter it out.
+const std::pair<std::string, std::string>& GetDataSet(size_t size) {
+    static std::map<size_t, std::pair<std::string, std::string>> data_sets;
+    auto [it, inserted] = data_sets.try_emplace(size);
+    if (inserted) {
+        it->second.first = MakeDataSet(size);
+        Tokenizer tokenizer{std::string_view(it->second.first)};
+        BinaryAstWriter writer;
+        while (!tokenizer.IsEnd()) {
+            writer.Add(Read(&tokenizer));
+        }
+        it->second.second = writer.Finish();
+    }
+    return it->second;
+}
+
+// Parsing the text against loading its binary form, from a small program to
+// a large data set. Both report throughput in bytes of text, so the numbers
+// compare directly. A MappedFileSource hands out the same in-memory view.
+int RegisterAll() {
+    const std::pair<std::string, size_t> kSizes[] = {
+        {"1KB", size_t{1} << 10},
+        {"1MB", size_t{1} << 20},
+        {"64MB", size_t{64} << 20},
+    };
+    for (const auto& [label, size] : kSizes) {
+        BenchmarkRegistration(
+            "binary_ast/parse/" + label,
+            [size](size_t iterations) {
+                const std::string& text = GetDataSet(size).first;
+                for (size_t i = 0; i < iterations; ++i) {
+                    Tokenizer tokenizer{std::string_view(text)};
+                    while (!tokenizer.IsEnd()) {
+                        DoNotOptimize(Read(&tokenizer));
+                    }
+                }
+            },
+            size);
+        BenchmarkRegistration(
+            "binary_ast/load/" + label,
+            [size](size_t iterations) {
+                const std::string& binary = GetDataSet(size).second;
+                for (size_t i = 0; i < iterations; ++i) {
+                    BinaryAstReader reader(binary);
+                    while (!reader.IsEnd()) {
+                        DoNotOptimize(reader.Read());
+                    }
+                }
+            },
+            size);
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
@@ -0,0 +1,51 @@
+#include "bench.h"
+#include "workloads.h"
+
+#include "scheme.h"
+
+#include <chrono>
+
+namespace {
+
+// The same Run unbounded and under limits generous enough never to trip:
+// the difference is the cost of the checks on the normal path.
+int RegisterAll() {
+    static const CancellationToken kToken;
+    const std::vector<std::pair<std::string, RunLimits>> kLimits = {
+        {"unbounded", {}},
+        {"fuel", {.max_steps = uint64_t{1} << 62}},
+        {"deadline", {.timeout = std::chrono::hours(1)}},
+        {"nodes", {.max_nodes = uint64_t{1} << 62}},
+        {"all",
+         {.max_steps = uint64_t{1} << 62,
+          .timeout = std::chrono::hours(1),
+          .max_nodes = uint64_t{1} << 62,
+          .cancel = &kToken}},
+    };
+    const std::vector<std::pair<std::string, std::string>> kExpressions = {
+        {"shallow", "(+ 1 2)"},
+        {"arithmetic_1000", MakeArithmeticChain(1000)},
+        {"wide_1000", MakeWideList(1000)},
+    };
+    for (const auto& [name, expr] : kExpressions) {
+        for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+            std::string evaluator = mode == EvalMode::kBytecode ? "bytecode/" : "tree/";
+            for (const auto& [limit, limits] : kLimits) {
+                BenchmarkRegistration("budget/" + evaluator + limit + "/" + name,
+                                      [mode, limits, expr](size_t iterations) {
+                                          Interpreter interpreter({.mode = mode});
+                                          std::string output;
+                                          for (size_t i = 0; i < iterations; ++i) {
+                                              interpreter.Run(expr, &output, limits);
+                                              DoNotOptimize(output.data());
+                                          }
+                                      });
+            }
+        }
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
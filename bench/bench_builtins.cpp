@@ -0,0 +1,67 @@
+#include "bench.h"
+
+#include "applier.h"
+#include "scheme.h"
+#include "vm.h"
+
+namespace {
+
+// One small call per builtin, arguments are literals so that the time is
+// dominated by dispatch, validation and argument passing.
+const std::vector<std::pair<std::string, std::string>> kCalls = {
+    {"number?", "(number? 1)"},
+    {"+", "(+ 1 2 3)"},
+    {"-", "(- 10 2 3)"},
+    {"*", "(* 2 3 4)"},
+    {"/", "(/ 100 5 2)"},
+    {"max", "(max 1 5 3)"},
+    {"min", "(min 4 2 6)"},
+    {"abs", "(abs -7)"},
+    {"=", "(= 1 1 1)"},
+    {"<", "(< 1 2 3)"},
+    {">", "(> 3 2 1)"},
+    {"<=", "(<= 1 1 2)"},
+    {">=", "(>= 2 2 1)"},
+    {"boolean?", "(boolean? #t)"},
+    {"not", "(not #f)"},
+    {"and", "(and 1 2 3)"},
+    {"or", "(or #f #f 3)"},
+    {"list?", "(list? '(1 2 3))"},
+    {"null?", "(null? '())"},
+    {"pair?", "(pair? '(1 2))"},
+    {"cons", "(cons 1 2)"},
+    {"car", "(car '(1 2))"},
+    {"cdr", "(cdr '(1 2))"},
+    {"list", "(list 1 2 3)"},
+    {"list-ref", "(list-ref '(1 2 3) 2)"},
+    {"list-tail", "(list-tail '(1 2 3) 1)"},
+};
+
+AST Parse(const std::string& expr) {
+    Tokenizer tokenizer{std::string_view(expr)};
+    return Read(&tokenizer);
+}
+
+// One iteration is one call, parsed and compiled up front.
+int RegisterAll() {
+    for (const auto& [name, expr] : kCalls) {
+        BenchmarkRegistration("builtins/tree/" + name, [expr](size_t iterations) {
+            AST ast = Parse(expr);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(Applier::Apply(ast));
+            }
+        });
+        BenchmarkRegistration("builtins/bytecode/" + name, [expr](size_t iterations) {
+            Program program = Compile(Parse(expr));
+            VirtualMachine vm;
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(vm.Run(program));
+            }
+        });
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
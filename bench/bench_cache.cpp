@@ -0,0 +1,79 @@
+#include "bench.h"
+
+#include "scheme.h"
+
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace {
+
+constexpr size_t kDistinct = 10000;
+constexpr size_t kRequests = 1 << 16;
+
+// kDistinct different expressions of realistic size, each printed with its own spacing.
+std::vector<std::string> MakeExpressions() {
+    std::vector<std::string> exprs;
+    for (size_t i = 0; i < kDistinct; ++i) {
+        std::string n = std::to_string(i);
+        switch (i % 4) {
+            case 0:
+                exprs.push_back("(max (+ " + n + " (* 2 3)) (- 10 4) (abs -7) (min 8 (/ 81 9)))");
+                break;
+            case 1:
+                exprs.push_back("(and (< 1 " + n + " 100000) (or #f (= 4 4)) (not #f))");
+                break;
+            case 2:
+                exprs.push_back("(list-ref (cons " + n + " '(1 2 3 4 5 6 7 8 9)) 7)");
+                break;
+            default:
+                exprs.push_back("(cdr  '(1 2 3 " + n + " 5 6 7 8 (9 10) (11 12)))");
+                break;
+        }
+    }
+    return exprs;
+}
+
+// Request indices drawn from a Zipf distribution with exponent s over kDistinct ranks.
+std::vector<size_t> MakeZipfRequests(double s) {
+    std::vector<double> cdf(kDistinct);
+    double sum = 0;
+    for (size_t rank = 0; rank < kDistinct; ++rank) {
+        sum += 1 / std::pow(rank + 1, s);
+        cdf[rank] = sum;
+    }
+    std::mt19937_64 gen(42);
+    std::uniform_real_distribution<double> uniform(0, sum);
+    std::vector<size_t> requests(kRequests);
+    for (auto& request : requests) {
+        request = std::lower_bound(cdf.begin(), cdf.end(), uniform(gen)) - cdf.begin();
+    }
+    return requests;
+}
+
+// One iteration is one request. The cache budget holds about a tenth of the
+// distinct expressions, so hit rates depend on the skew of the workload.
+int RegisterAll() {
+    for (double s : {0.8, 1.0, 1.2}) {
+        for (size_t cache_bytes : {size_t{0}, size_t{256} << 10}) {
+            std::string name = "cache/zipf_" + std::to_string(s).substr(0, 3) +
+                               (cache_bytes ? "/cached" : "/uncached");
+            BenchmarkRegistration(name, [s, cache_bytes](size_t iterations) {
+                static const std::vector<std::string> kExpressions = MakeExpressions();
+                std::vector<size_t> requests = MakeZipfRequests(s);
+                Interpreter interpreter({.cache_bytes = cache_bytes});
+                for (size_t i = 0; i < iterations; ++i) {
+                    try {
+                        DoNotOptimize(interpreter.Run(kExpressions[requests[i % kRequests]]));
+                    } catch (const RuntimeError&) {
+                    }
+                }
+            });
+        }
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
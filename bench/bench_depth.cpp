@@ -0,0 +1,52 @@
+#include "bench.h"
+
+#include "applier.h"
+#include "scheme.h"
+#include "symbol_table.h"
+#include "vm.h"
+
+namespace {
+
+// (+ 1 (+ 1 ... (+ 1 0))), built without the parser so that only evaluation is measured.
+AST MakeNestedSum(size_t depth) {
+    AST plus = Value::Unmanaged(SymbolTable::Intern("+"));
+    AST ast = MakeNumber(0);
+    for (size_t i = 0; i < depth; ++i) {
+        ast = MakeCell(plus, MakeCell(MakeNumber(1), MakeCell(ast, nullptr)));
+    }
+    return ast;
+}
+
+int RegisterAll() {
+    for (size_t depth : {1, 8, 1000, 100000}) {
+        std::string suffix = "/nested_sum_" + std::to_string(depth);
+        BenchmarkRegistration("depth/run/bytecode" + suffix, [depth](size_t iterations) {
+            AST ast = MakeNestedSum(depth);
+            VirtualMachine vm;
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(vm.Run(Compile(ast)));
+            }
+        });
+        BenchmarkRegistration("depth/apply/bytecode" + suffix, [depth](size_t iterations) {
+            Program program = Compile(MakeNestedSum(depth));
+            VirtualMachine vm;
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(vm.Run(program));
+            }
+        });
+        // The tree-walker refuses the pathological depth.
+        if (depth <= 1000) {
+            BenchmarkRegistration("depth/apply/tree" + suffix, [depth](size_t iterations) {
+                AST ast = MakeNestedSum(depth);
+                for (size_t i = 0; i < iterations; ++i) {
+                    DoNotOptimize(Applier::Apply(ast));
+                }
+            });
+        }
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
@@ -0,0 +1,79 @@
+#include "bench.h"
+
+#include "applier.h"
+#include "optimizer.h"
+#include "scheme.h"
+#include "vm.h"
+
+namespace {
+
+const std::vector<std::pair<std::string, std::string>> kExpressions = {
+    {"shallow", "(+ 1 2)"},
+    {"arithmetic", "(max (+ 1 (* 2 3)) (- 10 4) (abs -7) (min 8 (/ 81 9)))"},
+    {"boolean", "(and (< 1 2 3) (or #f (= 4 4)) (not #f) (>= 5 5 1))"},
+    {"quote", "'(1 2 3 4 5 6 7 8 (9 10) (11 12))"},
+    {"list", "(list-ref (cons 0 '(1 2 3 4 5 6 7 8 9)) 7)"},
+    {"nested", "(+ 1 (+ 2 (+ 3 (+ 4 (+ 5 (+ 6 (+ 7 (+ 8 (+ 9 10)))))))))"},
+    {"arithmetic_heavy",
+     "(max (* 12345 6789 (+ 1000 2000)) (+ 100000 (* 2000 3000 (max 4000 5000 6000)))"
+     " (* (+ 5000 6000) (max 7000 8000 (* 90 100))) (+ (* 1234 5678) (* 8765 4321)))"},
+};
+
+AST Parse(const std::string& expr) {
+    Tokenizer tokenizer{std::string_view(expr)};
+    return Read(&tokenizer);
+}
+
+const char* ModeName(EvalMode mode) {
+    return mode == EvalMode::kBytecode ? "bytecode" : "tree";
+}
+
+int RegisterAll() {
+    for (const auto& [name, expr] : kExpressions) {
+        for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+            for (bool optimize : {false, true}) {
+                std::string variant = std::string(ModeName(mode)) + (optimize ? "+optimize" : "");
+                BenchmarkRegistration("eval/run/" + variant + "/" + name,
+                                      [mode, optimize, expr](size_t iterations) {
+                                          Interpreter interpreter({.mode = mode, .optimize = optimize});
+                                          for (size_t i = 0; i < iterations; ++i) {
+                                              DoNotOptimize(interpreter.Run(expr));
+                                          }
+                                      });
+            }
+        }
+
+        // Evaluation only: the AST is parsed and compiled once up front.
+        BenchmarkRegistration("eval/apply/tree/" + name, [expr](size_t iterations) {
+            AST ast = Parse(expr);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(Applier::Apply(ast));
+            }
+        });
+        BenchmarkRegistration("eval/apply/bytecode/" + name, [expr](size_t iterations) {
+            Program program = Compile(Parse(expr));
+            VirtualMachine vm;
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(vm.Run(program));
+            }
+        });
+        BenchmarkRegistration("eval/optimize/" + name, [expr](size_t iterations) {
+            AST ast = Parse(expr);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(Optimize(
+                    ast, [](const AST& call) { return Applier::Apply(call); }, kDefaultMaxDepth));
+            }
+        });
+        BenchmarkRegistration("eval/compile/" + name, [expr](size_t iterations) {
+            AST ast = Parse(expr);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(Compile(ast));
+            }
+        });
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
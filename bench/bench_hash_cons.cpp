@@ -0,0 +1,64 @@
+#include "bench.h"
+
+#include "cons_table.h"
+#include "parser.h"
+
+#include <random>
+
+namespace {
+
+constexpr size_t kElements = 4096;
+constexpr size_t kShapes = 32;
+
+// '(e e e ...): kElements records drawn from kShapes distinct ones, so most
+// subtrees repeat, the way rows of generated data do.
+std::string MakeQuotedList() {
+    std::mt19937 gen(7);
+    std::string text = "'(";
+    for (size_t i = 0; i < kElements; ++i) {
+        size_t shape = gen() % kShapes;
+        text += "(row " + std::to_string(shape) + " (tags a b c) (1 2 3 " +
+                std::to_string(9000000000000000000 + shape) + ")) ";
+    }
+    text += ")";
+    return text;
+}
+
+AST Parse(const std::string& text) {
+    Tokenizer tokenizer{text};
+    return Read(&tokenizer);
+}
+
+// One iteration reads the whole list; the hash-consed variant pays a table
+// lookup per node and allocates one node per distinct subtree.
+int RegisterAll() {
+    for (bool hash_cons : {false, true}) {
+        std::string suffix = hash_cons ? "/hash_cons" : "/plain";
+        static const std::string kText = MakeQuotedList();
+
+        BenchmarkRegistration(
+            "hash_cons/parse" + suffix,
+            [hash_cons](size_t iterations) {
+                HashConsScope scope(hash_cons);
+                for (size_t i = 0; i < iterations; ++i) {
+                    DoNotOptimize(Parse(kText));
+                }
+            },
+            kText.size());
+
+        // Compares two separately read copies, equal all the way down.
+        BenchmarkRegistration("hash_cons/equal" + suffix, [hash_cons](size_t iterations) {
+            HashConsScope scope(hash_cons);
+            AST lhs = Parse(kText);
+            AST rhs = Parse(kText);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(IsEqual(lhs, rhs));
+            }
+        });
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
@@ -0,0 +1,69 @@
+#include "bench.h"
+
+#include "scheme.h"
+#include "parser.h"
+#include "symbol_table.h"
+#include "vm.h"
+
+namespace {
+
+constexpr size_t kLength = 100000;
+
+AST MakeSymbol(const std::string& name) {
+    return Value::Unmanaged(SymbolTable::Intern(name));
+}
+
+// (0 1 ... kLength-1), either as Read lays it out or as separately allocated cells.
+AST MakeNumbers(bool runs) {
+    std::vector<AST> items;
+    for (size_t i = 0; i < kLength; ++i) {
+        items.push_back(MakeNumber(i));
+    }
+    if (runs) {
+        return MakeList(items);
+    }
+    AST list;
+    for (size_t i = kLength; i > 0; --i) {
+        list = MakeCell(std::move(items[i - 1]), std::move(list));
+    }
+    return list;
+}
+
+// (name '<list> args...)
+AST MakeCall(const std::string& name, const AST& list, std::vector<AST> args) {
+    args.insert(args.begin(), MakeQuote(list));
+    return MakeCell(MakeSymbol(name), MakeList(args));
+}
+
+// One iteration is one call on a kLength-element list, evaluated by the VM.
+int RegisterAll() {
+    for (bool runs : {false, true}) {
+        std::string layout = runs ? "/runs" : "/cells";
+        const std::vector<std::pair<std::string, std::vector<AST>>> kCalls = {
+            {"list-ref", {MakeNumber(kLength - 1)}},
+            {"list-tail", {MakeNumber(kLength / 2)}},
+            {"list?", {}},
+        };
+        for (const auto& [name, args] : kCalls) {
+            BenchmarkRegistration(
+                "list/" + name + layout, [runs, name, args](size_t iterations) {
+                    VirtualMachine vm;
+                    Program program = Compile(MakeCall(name, MakeNumbers(runs), args));
+                    for (size_t i = 0; i < iterations; ++i) {
+                        DoNotOptimize(vm.Run(program));
+                    }
+                });
+        }
+        BenchmarkRegistration("list/print" + layout, [runs](size_t iterations) {
+            AST list = MakeNumbers(runs);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(AsString(list));
+            }
+        });
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
@@ -0,0 +1,39 @@
+#include "bench.h"
+#include "workloads.h"
+
+#include "scheme.h"
+
+namespace {
+
+// The same Run with memory accounting off and on: the difference is a
+// thread-local read and a few additions per allocation and per free.
+int RegisterAll() {
+    const std::vector<std::pair<std::string, std::string>> kExpressions = {
+        {"wide_1000", MakeWideList(1000)},
+        {"quote_heavy_1000", MakeQuoteHeavy(1000)},
+        {"arithmetic_1000", MakeArithmeticChain(1000)},
+    };
+    for (const auto& [name, expr] : kExpressions) {
+        for (bool use_arena : {false, true}) {
+            std::string heap = use_arena ? "arena/" : "heap/";
+            for (bool account : {false, true}) {
+                std::string variant = account ? "accounted/" : "off/";
+                BenchmarkRegistration("memory/" + heap + variant + name,
+                                      [use_arena, account, expr](size_t iterations) {
+                                          Interpreter interpreter(
+                                              {.use_arena = use_arena, .account_memory = account});
+                                          std::string output;
+                                          for (size_t i = 0; i < iterations; ++i) {
+                                              interpreter.Run(expr, &output);
+                                              DoNotOptimize(output.data());
+                                          }
+                                      });
+            }
+        }
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
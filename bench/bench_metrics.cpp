@@ -0,0 +1,46 @@
+#include "bench.h"
+#include "workloads.h"
+
+#include "scheme.h"
+
+namespace {
+
+// The same Run with metrics off and on; the difference is the cost of
+// collecting them, mostly two clock reads per builtin call and per stage.
+int RegisterAll() {
+    const std::vector<std::pair<std::string, std::string>> kExpressions = {
+        {"shallow", "(+ 1 2)"},
+        {"arithmetic_100", MakeArithmeticChain(100)},
+        {"deep_1000", MakeDeepNesting(1000)},
+    };
+    for (const auto& [name, expr] : kExpressions) {
+        for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+            for (bool metrics : {false, true}) {
+                std::string variant = mode == EvalMode::kBytecode ? "bytecode" : "tree";
+                variant += metrics ? "/on/" : "/off/";
+                BenchmarkRegistration(
+                    "metrics/run/" + variant + name, [mode, metrics, expr](size_t iterations) {
+                        Interpreter interpreter({.mode = mode, .metrics = metrics});
+                        std::string output;
+                        for (size_t i = 0; i < iterations; ++i) {
+                            interpreter.Run(expr, &output);
+                            DoNotOptimize(output.data());
+                        }
+                    });
+            }
+        }
+    }
+    BenchmarkRegistration("metrics/format_prometheus", [](size_t iterations) {
+        Interpreter interpreter({.metrics = true});
+        interpreter.Run(MakeArithmeticChain(100));
+        Metrics metrics = interpreter.GetMetrics();
+        for (size_t i = 0; i < iterations; ++i) {
+            DoNotOptimize(FormatPrometheus(metrics));
+        }
+    });
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
@@ -0,0 +1,73 @@
+#include "bench.h"
+
+#include "symbol_table.h"
+
+namespace {
+
+constexpr size_t kListLength = 10000;
+
+// The type check used before objects carried a type tag.
+template <class T>
+bool IsByRtti(const Value& value) {
+    return value.IsObject() && dynamic_cast<T*>(value.GetObject()) != nullptr;
+}
+
+// (a 'a (a) a 'a (a) ...): a long list mixing every kind of heap element.
+Value MakeDeepList() {
+    Value symbol = Value::Unmanaged(SymbolTable::Intern("a"));
+    Value list = nullptr;
+    for (size_t i = kListLength; i > 0; --i) {
+        Value element;
+        switch (i % 3) {
+            case 0:
+                element = symbol;
+                break;
+            case 1:
+                element = MakeQuote(symbol);
+                break;
+            default:
+                element = MakeCell(symbol, nullptr);
+                break;
+        }
+        list = MakeCell(element, list);
+    }
+    return list;
+}
+
+// Walks the list the way the evaluator does: every node is checked for
+// Cell and every element is checked against the remaining kinds in turn.
+template <bool kUseTags>
+size_t CountQuotes(const Value& list) {
+    auto is_cell = [](const auto& obj) { return kUseTags ? Is<Cell>(obj) : IsByRtti<Cell>(obj); };
+    auto is_quote = [](const auto& obj) {
+        return kUseTags ? Is<Quote>(obj) : IsByRtti<Quote>(obj);
+    };
+    auto is_symbol = [](const auto& obj) {
+        return kUseTags ? Is<Symbol>(obj) : IsByRtti<Symbol>(obj);
+    };
+    size_t count = 0;
+    for (const Cell* node = As<Cell>(list); node;) {
+        const auto& first = node->GetFirst();
+        if (is_quote(first)) {
+            ++count;
+        } else if (!is_symbol(first) && is_cell(first)) {
+            count += is_quote(As<Cell>(first)->GetFirst());
+        }
+        const auto& second = node->GetSecond();
+        node = is_cell(second) ? As<Cell>(second) : nullptr;
+    }
+    return count;
+}
+
+template <bool kUseTags>
+void BenchTypeChecks(size_t iterations) {
+    auto list = MakeDeepList();
+    for (size_t i = 0; i < iterations; ++i) {
+        DoNotOptimize(CountQuotes<kUseTags>(list));
+    }
+}
+
+BenchmarkRegistration rtti("object/type_check/dynamic_cast", BenchTypeChecks<false>);
+BenchmarkRegistration tags("object/type_check/tag", BenchTypeChecks<true>);
+
+}  // namespace
@@ -0,0 +1,54 @@
+#include "bench.h"
+
+#include "scheme.h"
+
+namespace {
+
+// What callers do today: write the inputs into the text, then run it.
+std::string Format(const std::string& prefix, int64_t a, int64_t b) {
+    return prefix + std::to_string(a) + " 3) " + std::to_string(b) + ")";
+}
+
+// The same template with changing inputs, run from rebuilt text and executed
+// from one prepared handle.
+int RegisterAll() {
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        std::string evaluator = mode == EvalMode::kBytecode ? "bytecode" : "tree";
+        BenchmarkRegistration("prepared/" + evaluator + "/run_text", [mode](size_t iterations) {
+            Interpreter interpreter({.mode = mode});
+            std::string output;
+            for (size_t i = 0; i < iterations; ++i) {
+                int64_t a = static_cast<int64_t>(i);
+                interpreter.Run(Format("(max (+ ", a, a * 7), &output);
+                DoNotOptimize(output.data());
+            }
+        });
+        BenchmarkRegistration("prepared/" + evaluator + "/execute", [mode](size_t iterations) {
+            Interpreter interpreter({.mode = mode});
+            auto prepared = interpreter.Prepare("(max (+ ?a 3) ?b)");
+            std::string output;
+            AST args[2];
+            for (size_t i = 0; i < iterations; ++i) {
+                int64_t a = static_cast<int64_t>(i);
+                args[0] = MakeNumber(a);
+                args[1] = MakeNumber(a * 7);
+                interpreter.Execute(*prepared, args, &output);
+                DoNotOptimize(output.data());
+            }
+        });
+    }
+    // Includes the cost of the vector of arguments made for every call.
+    BenchmarkRegistration("prepared/bytecode/execute_list", [](size_t iterations) {
+        Interpreter interpreter;
+        auto prepared = interpreter.Prepare("(max (+ ?a 3) ?b)");
+        for (size_t i = 0; i < iterations; ++i) {
+            int64_t a = static_cast<int64_t>(i);
+            DoNotOptimize(interpreter.Execute(*prepared, {a, a * 7}));
+        }
+    });
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
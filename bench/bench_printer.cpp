@@ -0,0 +1,75 @@
+#include "bench.h"
+
+#include "printer.h"
+#include "scheme.h"
+
+#include <sstream>
+
+namespace {
+
+AST Parse(const std::string& text) {
+    Tokenizer tokenizer{std::string_view(text)};
+    return Read(&tokenizer);
+}
+
+// A wide list of mixed atoms and short sublists, and a chain of nested lists.
+std::string MakeWide() {
+    std::string text = "(";
+    for (int i = 0; i < 10000; ++i) {
+        text += std::to_string(i * 7919) + " sym (#t . -" + std::to_string(i) + ") '(a) ";
+    }
+    return text + ")";
+}
+
+std::string MakeDeep() {
+    return std::string(10000, '(') + std::string(10000, ')');
+}
+
+// One iteration prints the whole value.
+int RegisterAll() {
+    const std::vector<std::pair<std::string, std::string>> kValues = {
+        {"wide", MakeWide()},
+        {"deep", MakeDeep()},
+    };
+    for (const auto& [name, text] : kValues) {
+        BenchmarkRegistration("printer/as_string/" + name, [text](size_t iterations) {
+            AST ast = Parse(text);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(AsString(ast));
+            }
+        });
+        BenchmarkRegistration("printer/buffer/" + name, [text](size_t iterations) {
+            AST ast = Parse(text);
+            std::string output;
+            for (size_t i = 0; i < iterations; ++i) {
+                output.clear();
+                Print(ast, &output);
+                DoNotOptimize(output.data());
+            }
+        });
+        BenchmarkRegistration("printer/stream/" + name, [text](size_t iterations) {
+            AST ast = Parse(text);
+            std::ostringstream stream;
+            for (size_t i = 0; i < iterations; ++i) {
+                stream.seekp(0);
+                Print(ast, &stream);
+            }
+            DoNotOptimize(stream.tellp());
+        });
+        // A cap a small fraction of the value stops the walk early.
+        BenchmarkRegistration("printer/capped/" + name, [text](size_t iterations) {
+            AST ast = Parse(text);
+            std::string output;
+            for (size_t i = 0; i < iterations; ++i) {
+                output.clear();
+                Print(ast, &output, {.max_size = 256, .max_depth = 8});
+                DoNotOptimize(output.data());
+            }
+        });
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
@@ -0,0 +1,104 @@
+#include "bench.h"
+#include "workloads.h"
+
+#include "applier.h"
+#include "scheme.h"
+#include "vm.h"
+
+namespace {
+
+AST Parse(const std::string& input) {
+    Tokenizer tokenizer{std::string_view(input)};
+    return Read(&tokenizer);
+}
+
+// One benchmark per stage of Run for every workload: stage/<stage>/<workload>_<size>.
+// Each stage starts from the output of the one before, prepared up front, and
+// reports throughput in bytes of the source text.
+void Register(const std::string& name, const std::string& input) {
+    size_t bytes = input.size();
+    BenchmarkRegistration(
+        "stage/tokenize/" + name,
+        [input](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                Tokenizer tokenizer{std::string_view(input)};
+                while (!tokenizer.IsEnd()) {
+                    DoNotOptimize(tokenizer.GetToken());
+                    tokenizer.Next();
+                }
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "stage/parse/" + name,
+        [input](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(Parse(input));
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "stage/compile/" + name,
+        [input](size_t iterations) {
+            AST ast = Parse(input);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(Compile(ast));
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "stage/eval/tree/" + name,
+        [input](size_t iterations) {
+            AST ast = Parse(input);
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(Applier::Apply(ast));
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "stage/eval/bytecode/" + name,
+        [input](size_t iterations) {
+            Program program = Compile(Parse(input));
+            VirtualMachine vm;
+            for (size_t i = 0; i < iterations; ++i) {
+                DoNotOptimize(vm.Run(program));
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "stage/print/" + name,
+        [input](size_t iterations) {
+            AST result = VirtualMachine().Run(Compile(Parse(input)));
+            std::string output;
+            for (size_t i = 0; i < iterations; ++i) {
+                output.clear();
+                Print(result, &output);
+                DoNotOptimize(output.data());
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "stage/run/" + name,
+        [input](size_t iterations) {
+            Interpreter interpreter;
+            std::string output;
+            for (size_t i = 0; i < iterations; ++i) {
+                interpreter.Run(input, &output);
+                DoNotOptimize(output.data());
+            }
+        },
+        bytes);
+}
+
+int RegisterAll() {
+    for (const auto& [name, make] : GetWorkloads()) {
+        for (size_t size : {100, 10000}) {
+            Register(name + "_" + std::to_string(size), make(size));
+        }
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
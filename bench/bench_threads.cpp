@@ -0,0 +1,53 @@
+#include "bench.h"
+
+#include "scheme.h"
+
+#include <thread>
+
+namespace {
+
+const std::vector<std::string> kExpressions = {
+    "(max (+ 1 (* 2 3)) (- 10 4) (abs -7) (min 8 (/ 81 9)))",
+    "(and (< 1 2 3) (or #f (= 4 4)) (not #f) (>= 5 5 1))",
+    "(list-ref (cons 0 '(1 2 3 4 5 6 7 8 9)) 7)",
+    "'(1 2 3 4 5 6 7 8 (9 10) (11 12))",
+};
+
+const char* ModeName(EvalMode mode) {
+    return mode == EvalMode::kBytecode ? "bytecode" : "tree";
+}
+
+// Every thread owns an interpreter and evaluates `iterations` expressions, so the
+// reported time per iteration is the inverse of the throughput of one core. It
+// stays flat as threads are added for as long as the interpreters share nothing.
+int RegisterAll() {
+    size_t max_threads = std::max(1u, std::thread::hardware_concurrency());
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        for (size_t threads = 1;; threads = std::min(threads * 2, max_threads)) {
+            std::string name = std::string("threads/run/") + ModeName(mode) + "/x" +
+                               std::to_string(threads);
+            BenchmarkRegistration(name, [mode, threads](size_t iterations) {
+                std::vector<std::thread> workers;
+                for (size_t t = 0; t < threads; ++t) {
+                    workers.emplace_back([mode, iterations, t] {
+                        Interpreter interpreter({.mode = mode, .use_arena = true});
+                        for (size_t i = 0; i < iterations; ++i) {
+                            DoNotOptimize(interpreter.Run(kExpressions[(i + t) % kExpressions.size()]));
+                        }
+                    });
+                }
+                for (auto& worker : workers) {
+                    worker.join();
+                }
+            });
+            if (threads == max_threads) {
+                break;
+            }
+        }
+    }
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
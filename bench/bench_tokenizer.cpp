@@ -0,0 +1,112 @@
+#include "bench.h"
+
+#include "tokenizer.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include <unistd.h>
+
+namespace {
+
+constexpr size_t kInputSize = 1 << 20;
+
+// A mix of every token kind, about kInputSize bytes long.
+std::string MakeProgram() {
+    std::string program;
+    for (size_t i = 0; program.size() < kInputSize; ++i) {
+        program += "(list-ref '(" + std::to_string(i * 7919) + " #t #f foo-bar? (a . b)) ";
+        program += "(+ -" + std::to_string(i) + " (* 12 345)))\n";
+    }
+    return program;
+}
+
+void Drain(Tokenizer* tokenizer) {
+    while (!tokenizer->IsEnd()) {
+        DoNotOptimize(tokenizer->GetToken());
+        tokenizer->Next();
+    }
+}
+
+// The program written to a temporary file, removed at exit.
+class ProgramFile {
+public:
+    ProgramFile(const std::string& program) {
+        char path[] = "/tmp/scheme_bench_tokenizer_XXXXXX";
+        int fd = mkstemp(path);
+        if (fd < 0 || write(fd, program.data(), program.size()) != ssize_t(program.size())) {
+            std::perror("scheme_bench: temporary file");
+            return;
+        }
+        close(fd);
+        path_ = path;
+    }
+    ~ProgramFile() {
+        if (!path_.empty()) {
+            unlink(path_.c_str());
+        }
+    }
+
+    const std::string& GetPath() const {
+        return path_;
+    }
+
+private:
+    std::string path_;
+};
+
+int RegisterAll() {
+    static const std::string kProgram = MakeProgram();
+    static const ProgramFile kFile(kProgram);
+    size_t bytes = kProgram.size();
+
+    BenchmarkRegistration(
+        "tokenizer/stringstream",
+        [](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                std::stringstream ss{kProgram};
+                Tokenizer tokenizer{&ss};
+                Drain(&tokenizer);
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "tokenizer/string_view",
+        [](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                Tokenizer tokenizer{std::string_view(kProgram)};
+                Drain(&tokenizer);
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "tokenizer/fd",
+        [](size_t iterations) {
+            FILE* file = std::fopen(kFile.GetPath().c_str(), "r");
+            for (size_t i = 0; file && i < iterations; ++i) {
+                lseek(fileno(file), 0, SEEK_SET);
+                FdSource source(fileno(file));
+                Tokenizer tokenizer{&source};
+                Drain(&tokenizer);
+            }
+            if (file) {
+                std::fclose(file);
+            }
+        },
+        bytes);
+    BenchmarkRegistration(
+        "tokenizer/mmap",
+        [](size_t iterations) {
+            for (size_t i = 0; i < iterations; ++i) {
+                MappedFileSource source(kFile.GetPath());
+                Tokenizer tokenizer{&source};
+                Drain(&tokenizer);
+            }
+        },
+        bytes);
+    return 0;
+}
+
+const int kRegistered = RegisterAll();
+
+}  // namespace
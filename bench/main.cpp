@@ -0,0 +1,76 @@
+#include "bench.h"
+
+#include <cstdio>
+#include <cstring>
+
+// Usage: scheme_bench [--json] [filter]
+//
+// Runs every benchmark whose name contains `filter`. With --json the results
+// are written to stdout as one JSON document, for tools that track them over
+// time:
+//
+//   {"benchmarks": [{"name": "...", "iterations": 1000, "ns_per_op": 12.5,
+//                    "mb_per_s": 80.0}, ...]}
+//
+// mb_per_s is present only for benchmarks that report throughput.
+
+static void PrintText(const std::vector<BenchmarkResult>& results) {
+    for (const auto& result : results) {
+        std::printf("%-48s %12zu %14.1f ns/op", result.name.c_str(), result.iterations,
+                    result.ns_per_iteration);
+        if (result.megabytes_per_second > 0) {
+            std::printf(" %10.1f MB/s", result.megabytes_per_second);
+        }
+        std::printf("\n");
+    }
+}
+
+static void PrintJsonString(const std::string& text) {
+    std::putchar('"');
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            std::putchar('\\');
+            std::putchar(c);
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            std::printf("\\u%04x", c);
+        } else {
+            std::putchar(c);
+        }
+    }
+    std::putchar('"');
+}
+
+static void PrintJson(const std::vector<BenchmarkResult>& results) {
+    std::printf("{\"benchmarks\": [");
+    for (size_t i = 0; i < results.size(); ++i) {
+        const auto& result = results[i];
+        std::printf(i ? ",\n  {\"name\": " : "\n  {\"name\": ");
+        PrintJsonString(result.name);
+        std::printf(", \"iterations\": %zu, \"ns_per_op\": %.3f", result.iterations,
+                    result.ns_per_iteration);
+        if (result.megabytes_per_second > 0) {
+            std::printf(", \"mb_per_s\": %.3f", result.megabytes_per_second);
+        }
+        std::printf("}");
+    }
+    std::printf("\n]}\n");
+}
+
+int main(int argc, char** argv) {
+    bool json = false;
+    std::string filter;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--json") == 0) {
+            json = true;
+        } else {
+            filter = argv[i];
+        }
+    }
+    auto results = RunBenchmarks(filter);
+    if (json) {
+        PrintJson(results);
+    } else {
+        PrintText(results);
+    }
+    return 0;
+}
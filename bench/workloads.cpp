@@ -0,0 +1,56 @@
+#include "workloads.h"
+
+std::string MakeWideList(size_t length) {
+    std::string input = "'(";
+    for (size_t i = 0; i < length; ++i) {
+        input += std::to_string(i) + " ";
+    }
+    return input + ")";
+}
+
+std::string MakeDeepNesting(size_t depth) {
+    std::string input;
+    for (size_t i = 0; i < depth; ++i) {
+        input += "(+ 1 ";
+    }
+    input += "0";
+    return input + std::string(depth, ')');
+}
+
+std::string MakeArithmeticChain(size_t length) {
+    std::string input = "(+";
+    for (size_t i = 0; i < length; ++i) {
+        input += i % 2 ? " (- " : " (* ";
+        input += std::to_string(i) + (i % 2 ? " 2)" : " 3)");
+    }
+    return input + ")";
+}
+
+std::string MakeShortCircuit(size_t length) {
+    std::string input = "(and";
+    for (size_t i = 0; i < length; ++i) {
+        std::string index = std::to_string(i);
+        input += i == length / 2 ? " (= " + index + " 0 1)" : " (< " + index + " " + index + "1)";
+    }
+    return input + ")";
+}
+
+std::string MakeQuoteHeavy(size_t length) {
+    static const char* kQuotes[] = {" 'foo", " '(1 'bar)", " ''baz"};
+    std::string input = "(list";
+    for (size_t i = 0; i < length; ++i) {
+        input += kQuotes[i % 3];
+    }
+    return input + ")";
+}
+
+const std::vector<Workload>& GetWorkloads() {
+    static const std::vector<Workload> kWorkloads = {
+        {"wide", MakeWideList},
+        {"deep", MakeDeepNesting},
+        {"arithmetic", MakeArithmeticChain},
+        {"short_circuit", MakeShortCircuit},
+        {"quotes", MakeQuoteHeavy},
+    };
+    return kWorkloads;
+}
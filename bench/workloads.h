@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+// Synthetic programs for scheme_bench. Each generator returns the text of one
+// expression that both evaluators accept, scaled by `size`: the number of
+// elements, levels or operands.
+
+struct Workload {
+    std::string name;
+    std::string (*make)(size_t size);
+};
+
+// '(0 1 2 ...): one long flat list.
+std::string MakeWideList(size_t length);
+
+// (+ 1 (+ 1 ... 0)): one element per level.
+std::string MakeDeepNesting(size_t depth);
+
+// (+ (* 0 3) (- 1 2) (* 2 3) ...): a flat chain of small arithmetic calls.
+std::string MakeArithmeticChain(size_t length);
+
+// (and (< 0 1) ... (= 0 1) ...): the comparison halfway along is false, so
+// only the first half is evaluated.
+std::string MakeShortCircuit(size_t length);
+
+// (list 'foo '(1 'bar) ''baz ...): quotes nested one to three deep.
+std::string MakeQuoteHeavy(size_t length);
+
+// Every generator above, named wide, deep, arithmetic, short_circuit and quotes.
+const std::vector<Workload>& GetWorkloads();
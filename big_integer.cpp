@@ -0,0 +1,294 @@
+#include "big_integer.h"
+#include <utility>
+#include <bit>
+
+using Limbs = std::vector<uint32_t>;
+
+static constexpr uint64_t kBase = uint64_t{1} << 32;
+// The largest power of ten that fits into a limb, for decimal conversions.
+static constexpr uint32_t kDecimalBase = 1000000000;
+static constexpr size_t kDecimalDigits = 9;
+
+static void Trim(Limbs* limbs) {
+    while (!limbs->empty() && limbs->back() == 0) {
+        limbs->pop_back();
+    }
+}
+
+static int CompareMagnitude(const Limbs& lhs, const Limbs& rhs) {
+    if (lhs.size() != rhs.size()) {
+        return lhs.size() < rhs.size() ? -1 : 1;
+    }
+    for (size_t i = lhs.size(); i-- > 0;) {
+        if (lhs[i] != rhs[i]) {
+            return lhs[i] < rhs[i] ? -1 : 1;
+        }
+    }
+    return 0;
+}
+
+static Limbs AddMagnitude(const Limbs& lhs, const Limbs& rhs) {
+    const Limbs& longer = lhs.size() >= rhs.size() ? lhs : rhs;
+    const Limbs& shorter = lhs.size() >= rhs.size() ? rhs : lhs;
+    Limbs result(longer.size() + 1);
+    uint64_t carry = 0;
+    for (size_t i = 0; i < longer.size(); ++i) {
+        uint64_t sum = carry + longer[i] + (i < shorter.size() ? shorter[i] : 0);
+        result[i] = static_cast<uint32_t>(sum);
+        carry = sum >> 32;
+    }
+    result.back() = static_cast<uint32_t>(carry);
+    Trim(&result);
+    return result;
+}
+
+// `lhs` must not be less than `rhs`.
+static Limbs SubtractMagnitude(const Limbs& lhs, const Limbs& rhs) {
+    Limbs result(lhs.size());
+    uint64_t borrow = 0;
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        uint64_t subtrahend = borrow + (i < rhs.size() ? rhs[i] : 0);
+        borrow = lhs[i] < subtrahend;
+        result[i] = static_cast<uint32_t>(lhs[i] + (borrow ? kBase : 0) - subtrahend);
+    }
+    Trim(&result);
+    return result;
+}
+
+static Limbs MultiplyMagnitude(const Limbs& lhs, const Limbs& rhs) {
+    if (lhs.empty() || rhs.empty()) {
+        return {};
+    }
+    Limbs result(lhs.size() + rhs.size());
+    for (size_t i = 0; i < lhs.size(); ++i) {
+        uint64_t carry = 0;
+        for (size_t j = 0; j < rhs.size(); ++j) {
+            // At most (2^32 - 1)^2 + 2 * (2^32 - 1), which still fits.
+            uint64_t product = uint64_t{lhs[i]} * rhs[j] + result[i + j] + carry;
+            result[i + j] = static_cast<uint32_t>(product);
+            carry = product >> 32;
+        }
+        result[i + rhs.size()] = static_cast<uint32_t>(carry);
+    }
+    Trim(&result);
+    return result;
+}
+
+// Divides in place by a single limb and returns the remainder.
+static uint32_t DivideMagnitude(Limbs* limbs, uint32_t divisor) {
+    uint64_t remainder = 0;
+    for (size_t i = limbs->size(); i-- > 0;) {
+        uint64_t current = (remainder << 32) | (*limbs)[i];
+        (*limbs)[i] = static_cast<uint32_t>(current / divisor);
+        remainder = current % divisor;
+    }
+    Trim(limbs);
+    return static_cast<uint32_t>(remainder);
+}
+
+// Multiplies in place by a single limb and adds `addend`.
+static void MultiplyAddMagnitude(Limbs* limbs, uint32_t factor, uint32_t addend) {
+    uint64_t carry = addend;
+    for (uint32_t& limb : *limbs) {
+        uint64_t product = uint64_t{limb} * factor + carry;
+        limb = static_cast<uint32_t>(product);
+        carry = product >> 32;
+    }
+    if (carry != 0) {
+        limbs->push_back(static_cast<uint32_t>(carry));
+    }
+}
+
+static Limbs ShiftLeft(const Limbs& limbs, int shift, size_t extra) {
+    Limbs result(limbs.size() + extra);
+    for (size_t i = 0; i < limbs.size(); ++i) {
+        uint64_t shifted = uint64_t{limbs[i]} << shift;
+        result[i] |= static_cast<uint32_t>(shifted);
+        if (i + 1 < result.size()) {
+            result[i + 1] |= static_cast<uint32_t>(shifted >> 32);
+        }
+    }
+    return result;
+}
+
+// Schoolbook long division, Knuth's Algorithm D: the divisor is normalized so
+// that its top limb has the high bit set, which keeps each estimated quotient
+// limb at most two above the true one.
+static Limbs DivideMagnitude(const Limbs& dividend, const Limbs& divisor) {
+    if (CompareMagnitude(dividend, divisor) < 0) {
+        return {};
+    }
+    if (divisor.size() == 1) {
+        Limbs quotient = dividend;
+        DivideMagnitude(&quotient, divisor[0]);
+        return quotient;
+    }
+    int shift = std::countl_zero(divisor.back());
+    Limbs v = ShiftLeft(divisor, shift, 0);
+    Limbs u = ShiftLeft(dividend, shift, 1);
+    size_t n = v.size();
+    size_t m = dividend.size() - n;
+    Limbs quotient(m + 1);
+    for (size_t j = m + 1; j-- > 0;) {
+        uint64_t numerator = (uint64_t{u[j + n]} << 32) | u[j + n - 1];
+        uint64_t estimate = numerator / v[n - 1];
+        uint64_t remainder = numerator % v[n - 1];
+        while (estimate >= kBase || estimate * v[n - 2] > ((remainder << 32) | u[j + n - 2])) {
+            --estimate;
+            remainder += v[n - 1];
+            if (remainder >= kBase) {
+                break;
+            }
+        }
+        // u[j..j+n] -= estimate * v
+        uint64_t carry = 0;
+        int64_t borrow = 0;
+        for (size_t i = 0; i < n; ++i) {
+            uint64_t product = estimate * v[i] + carry;
+            carry = product >> 32;
+            int64_t difference =
+                int64_t{u[i + j]} - borrow - static_cast<int64_t>(product & (kBase - 1));
+            u[i + j] = static_cast<uint32_t>(difference);
+            borrow = difference < 0;
+        }
+        int64_t difference = int64_t{u[j + n]} - borrow - static_cast<int64_t>(carry);
+        u[j + n] = static_cast<uint32_t>(difference);
+        if (difference < 0) {
+            // The estimate was one too large: add the divisor back once.
+            --estimate;
+            uint64_t sum_carry = 0;
+            for (size_t i = 0; i < n; ++i) {
+                uint64_t sum = uint64_t{u[i + j]} + v[i] + sum_carry;
+                u[i + j] = static_cast<uint32_t>(sum);
+                sum_carry = sum >> 32;
+            }
+            u[j + n] += static_cast<uint32_t>(sum_carry);
+        }
+        quotient[j] = static_cast<uint32_t>(estimate);
+    }
+    Trim(&quotient);
+    return quotient;
+}
+
+BigInteger::BigInteger(bool negative, std::vector<uint32_t> limbs)
+    : negative_(negative), limbs_(std::move(limbs)) {
+    Trim(&limbs_);
+    if (limbs_.empty()) {
+        negative_ = false;
+    }
+}
+
+BigInteger::BigInteger(int64_t value) : negative_(value < 0) {
+    // Negated unsigned so that the minimum int64_t has a magnitude too.
+    uint64_t magnitude = negative_ ? 0 - static_cast<uint64_t>(value) : value;
+    while (magnitude != 0) {
+        limbs_.push_back(static_cast<uint32_t>(magnitude));
+        magnitude >>= 32;
+    }
+}
+
+BigInteger BigInteger::FromLimbs(bool negative, std::span<const uint32_t> limbs) {
+    return BigInteger(negative, Limbs(limbs.begin(), limbs.end()));
+}
+
+BigInteger BigInteger::FromDecimal(std::string_view text) {
+    bool negative = text.starts_with('-');
+    std::string_view digits = text.substr(negative);
+    Limbs limbs;
+    // The first chunk takes the leftover digits, every other one kDecimalDigits.
+    size_t chunk = digits.size() % kDecimalDigits;
+    if (chunk == 0) {
+        chunk = kDecimalDigits;
+    }
+    for (size_t start = 0; start < digits.size(); start += chunk, chunk = kDecimalDigits) {
+        uint32_t value = 0;
+        for (char digit : digits.substr(start, chunk)) {
+            value = value * 10 + (digit - '0');
+        }
+        MultiplyAddMagnitude(&limbs, kDecimalBase, value);
+    }
+    return BigInteger(negative, std::move(limbs));
+}
+
+bool BigInteger::ToInt64(int64_t* value) const {
+    if (limbs_.size() > 2) {
+        return false;
+    }
+    uint64_t magnitude = 0;
+    for (size_t i = limbs_.size(); i-- > 0;) {
+        magnitude = (magnitude << 32) | limbs_[i];
+    }
+    uint64_t limit = negative_ ? uint64_t{1} << 63 : (uint64_t{1} << 63) - 1;
+    if (magnitude > limit) {
+        return false;
+    }
+    *value = negative_ ? static_cast<int64_t>(0 - magnitude) : static_cast<int64_t>(magnitude);
+    return true;
+}
+
+std::string BigInteger::ToString() const {
+    if (IsZero()) {
+        return "0";
+    }
+    // Peels off nine decimal digits per short division, least significant first.
+    Limbs magnitude = limbs_;
+    std::vector<uint32_t> chunks;
+    while (!magnitude.empty()) {
+        chunks.push_back(DivideMagnitude(&magnitude, kDecimalBase));
+    }
+    std::string output = negative_ ? "-" : "";
+    output += std::to_string(chunks.back());
+    for (size_t i = chunks.size() - 1; i-- > 0;) {
+        std::string digits = std::to_string(chunks[i]);
+        output.append(kDecimalDigits - digits.size(), '0');
+        output += digits;
+    }
+    return output;
+}
+
+size_t BigInteger::Hash() const {
+    uint64_t hash = negative_;
+    for (uint32_t limb : limbs_) {
+        hash = (hash ^ limb) * 0x9e3779b97f4a7c15;
+    }
+    return hash;
+}
+
+BigInteger BigInteger::operator-() const {
+    return BigInteger(!negative_, limbs_);
+}
+
+BigInteger BigInteger::Abs() const {
+    return BigInteger(false, limbs_);
+}
+
+BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs) {
+    if (lhs.negative_ == rhs.negative_) {
+        return BigInteger(lhs.negative_, AddMagnitude(lhs.limbs_, rhs.limbs_));
+    }
+    // Opposite signs: the larger magnitude decides the sign.
+    if (CompareMagnitude(lhs.limbs_, rhs.limbs_) >= 0) {
+        return BigInteger(lhs.negative_, SubtractMagnitude(lhs.limbs_, rhs.limbs_));
+    }
+    return BigInteger(rhs.negative_, SubtractMagnitude(rhs.limbs_, lhs.limbs_));
+}
+
+BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs) {
+    return lhs + -rhs;
+}
+
+BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs) {
+    return BigInteger(lhs.negative_ != rhs.negative_, MultiplyMagnitude(lhs.limbs_, rhs.limbs_));
+}
+
+BigInteger operator/(const BigInteger& lhs, const BigInteger& rhs) {
+    return BigInteger(lhs.negative_ != rhs.negative_, DivideMagnitude(lhs.limbs_, rhs.limbs_));
+}
+
+int Compare(const BigInteger& lhs, const BigInteger& rhs) {
+    if (lhs.negative_ != rhs.negative_) {
+        return lhs.negative_ ? -1 : 1;
+    }
+    int magnitude = CompareMagnitude(lhs.limbs_, rhs.limbs_);
+    return lhs.negative_ ? -magnitude : magnitude;
+}
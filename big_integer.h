@@ -0,0 +1,63 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// Arbitrary-precision integer, the boxed form of the numbers that overflow
+// a fixnum. The magnitude is stored in base 2^32 limbs, least significant
+// first and without leading zero limbs; zero has no limbs and no sign.
+// Division truncates toward zero like int64_t division.
+class BigInteger {
+public:
+    BigInteger() = default;
+    explicit BigInteger(int64_t value);
+
+    // `text` is one or more decimal digits, optionally after a minus sign.
+    static BigInteger FromDecimal(std::string_view text);
+    // The magnitude in base 2^32, least significant limb first.
+    static BigInteger FromLimbs(bool negative, std::span<const uint32_t> limbs);
+
+    std::span<const uint32_t> GetLimbs() const {
+        return limbs_;
+    }
+
+    bool IsNegative() const {
+        return negative_;
+    }
+    bool IsZero() const {
+        return limbs_.empty();
+    }
+
+    // Stores the value into *value and returns true if it fits into int64_t.
+    bool ToInt64(int64_t* value) const;
+    std::string ToString() const;
+    size_t Hash() const;
+
+    BigInteger operator-() const;
+    BigInteger Abs() const;
+
+    friend BigInteger operator+(const BigInteger& lhs, const BigInteger& rhs);
+    friend BigInteger operator-(const BigInteger& lhs, const BigInteger& rhs);
+    friend BigInteger operator*(const BigInteger& lhs, const BigInteger& rhs);
+    // The divisor must not be zero.
+    friend BigInteger operator/(const BigInteger& lhs, const BigInteger& rhs);
+
+    // Negative, zero or positive as lhs is less than, equal to or greater than rhs.
+    friend int Compare(const BigInteger& lhs, const BigInteger& rhs);
+    friend bool operator==(const BigInteger& lhs, const BigInteger& rhs) = default;
+
+private:
+    BigInteger(bool negative, std::vector<uint32_t> limbs);
+
+    bool negative_ = false;
+    std::vector<uint32_t> limbs_;
+};
+
+struct BigIntegerHash {
+    size_t operator()(const BigInteger& value) const {
+        return value.Hash();
+    }
+};
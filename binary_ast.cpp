@@ -0,0 +1,313 @@
+#include "binary_ast.h"
+#include "symbol_table.h"
+
+namespace {
+
+void AppendVarint(std::string* output, uint64_t value) {
+    while (value >= 0x80) {
+        output->push_back(static_cast<char>(value | 0x80));
+        value >>= 7;
+    }
+    output->push_back(static_cast<char>(value));
+}
+
+void AppendTag(std::string* output, BinaryAstTag tag) {
+    output->push_back(static_cast<char>(tag));
+}
+
+uint64_t ZigZag(int64_t value) {
+    return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+}
+
+int64_t UnZigZag(uint64_t value) {
+    return static_cast<int64_t>(value >> 1) ^ -static_cast<int64_t>(value & 1);
+}
+
+SyntaxError Malformed(const char* what) {
+    return SyntaxError(std::string("Syntax error: malformed binary AST, ") + what);
+}
+
+// A list or quote whose node is not complete yet.
+struct Frame {
+    enum class Kind { kQuote, kList, kTail };
+    Kind kind;
+    // Where the elements of the list start in `items`.
+    size_t start = 0;
+    // Elements still to read, then whether a tail follows them.
+    uint64_t remaining = 0;
+    bool dotted = false;
+};
+
+}  // namespace
+
+bool IsBinaryAst(std::string_view data) {
+    return data.starts_with(kBinaryAstMagic);
+}
+
+uint64_t BinaryAstWriter::GetSymbolIndex(const Symbol* symbol) {
+    auto [it, inserted] = symbol_indices_.try_emplace(symbol, symbols_.size());
+    if (inserted) {
+        symbols_.push_back(symbol);
+    }
+    return it->second;
+}
+
+void BinaryAstWriter::WriteAtom(const AST& atom) {
+    if (atom == nullptr) {
+        AppendTag(&scratch_, BinaryAstTag::kEmptyList);
+        return;
+    }
+    switch (atom.GetType()) {
+        case ObjectType::kBoolean:
+            AppendTag(&scratch_, atom.GetBoolean() ? BinaryAstTag::kTrue : BinaryAstTag::kFalse);
+            return;
+        case ObjectType::kNumber: {
+            int64_t value;
+            if (atom.IsFixnum()) {
+                value = atom.GetNumber();
+            } else if (BigInteger big = As<Number>(atom)->GetValue(); !big.ToInt64(&value)) {
+                AppendTag(&scratch_, BinaryAstTag::kBigInteger);
+                AppendVarint(&scratch_, big.GetLimbs().size() * 2 + big.IsNegative());
+                for (uint32_t limb : big.GetLimbs()) {
+                    for (int shift = 0; shift < 32; shift += 8) {
+                        scratch_.push_back(static_cast<char>(limb >> shift));
+                    }
+                }
+                return;
+            }
+            AppendTag(&scratch_, BinaryAstTag::kInteger);
+            AppendVarint(&scratch_, ZigZag(value));
+            return;
+        }
+        case ObjectType::kSymbol:
+            AppendTag(&scratch_, BinaryAstTag::kSymbol);
+            AppendVarint(&scratch_, GetSymbolIndex(As<Symbol>(atom)));
+            return;
+        case ObjectType::kQuote:
+        case ObjectType::kCell:
+            break;
+    }
+}
+
+// Nodes are written in preorder. Lists are walked by following their links
+// like the printer does, an open list costs one frame however long it is.
+void BinaryAstWriter::Add(const AST& form) {
+    // The part of each open list still to write, nullptr once it is done.
+    std::vector<const AST*> stack;
+    scratch_.clear();
+    const AST* next = &form;
+    while (true) {
+        if (next) {
+            const AST& node = *next;
+            next = nullptr;
+            if (Is<Quote>(node)) {
+                AppendTag(&scratch_, BinaryAstTag::kQuote);
+                next = &As<Quote>(node)->GetCommand();
+            } else if (Is<Cell>(node)) {
+                uint64_t length = 0;
+                const AST* tail = &node;
+                while (Is<Cell>(*tail)) {
+                    ++length;
+                    tail = &As<Cell>(*tail)->GetSecond();
+                }
+                AppendTag(&scratch_,
+                          *tail == nullptr ? BinaryAstTag::kList : BinaryAstTag::kDottedList);
+                AppendVarint(&scratch_, length);
+                stack.push_back(&node);
+            } else {
+                WriteAtom(node);
+            }
+            continue;
+        }
+        if (stack.empty()) {
+            break;
+        }
+        const AST*& rest = stack.back();
+        if (rest == nullptr || *rest == nullptr) {
+            stack.pop_back();
+        } else if (!Is<Cell>(*rest)) {
+            next = rest;
+            rest = nullptr;
+        } else {
+            next = &As<Cell>(*rest)->GetFirst();
+            rest = &As<Cell>(*rest)->GetSecond();
+        }
+    }
+    AppendVarint(&forms_, scratch_.size());
+    forms_ += scratch_;
+}
+
+std::string BinaryAstWriter::Finish() const {
+    std::string output(kBinaryAstMagic);
+    output.push_back(static_cast<char>(kBinaryAstVersion));
+    AppendVarint(&output, symbols_.size());
+    for (const Symbol* symbol : symbols_) {
+        AppendVarint(&output, symbol->GetName().size());
+        output += symbol->GetName();
+    }
+    return output + forms_;
+}
+
+BinaryAstReader::BinaryAstReader(std::string_view data) : data_(data) {
+    if (!IsBinaryAst(data_)) {
+        throw Malformed("bad magic");
+    }
+    position_ = kBinaryAstMagic.size();
+    if (ReadByte(data_.size()) != kBinaryAstVersion) {
+        throw SyntaxError("Syntax error: unsupported binary AST version");
+    }
+    uint64_t count = ReadVarint(data_.size());
+    // Every entry takes at least its length byte.
+    if (count > data_.size() - position_) {
+        throw Malformed("symbol table too large");
+    }
+    symbols_.reserve(count);
+    for (uint64_t i = 0; i < count; ++i) {
+        uint64_t size = ReadVarint(data_.size());
+        if (size == 0 || size > data_.size() - position_) {
+            throw Malformed("bad symbol name");
+        }
+        std::string_view name = data_.substr(position_, size);
+        // The parser never makes the bare symbol, evaluators rely on it.
+        if (name == "quote") {
+            throw SyntaxError("Syntax error: incorrect form 'quote'");
+        }
+        symbols_.push_back(SymbolTable::Intern(name));
+        position_ += size;
+    }
+    form_end_ = position_;
+}
+
+uint8_t BinaryAstReader::ReadByte(size_t end) {
+    if (position_ >= end) {
+        throw Malformed("unexpected end");
+    }
+    return static_cast<uint8_t>(data_[position_++]);
+}
+
+uint64_t BinaryAstReader::ReadVarint(size_t end) {
+    uint64_t value = 0;
+    for (int shift = 0; shift < 64; shift += 7) {
+        uint8_t byte = ReadByte(end);
+        value |= static_cast<uint64_t>(byte & 0x7f) << shift;
+        if (!(byte & 0x80)) {
+            return value;
+        }
+    }
+    throw Malformed("varint too long");
+}
+
+AST BinaryAstReader::ReadBigInteger(size_t end) {
+    uint64_t header = ReadVarint(end);
+    uint64_t count = header / 2;
+    if (count > (end - position_) / 4) {
+        throw Malformed("unexpected end");
+    }
+    std::vector<uint32_t> limbs(count);
+    for (uint32_t& limb : limbs) {
+        for (int shift = 0; shift < 32; shift += 8) {
+            limb |= static_cast<uint32_t>(static_cast<uint8_t>(data_[position_++])) << shift;
+        }
+    }
+    return MakeNumber(BigInteger::FromLimbs(header & 1, limbs));
+}
+
+// Mirrors Read: open nodes are kept in frames on the heap, so nesting is
+// only bounded by max_depth.
+AST BinaryAstReader::Read(size_t max_depth) {
+    // Without a usable size nothing after this point can be found again.
+    form_end_ = data_.size();
+    uint64_t size = ReadVarint(data_.size());
+    if (size > data_.size() - position_) {
+        throw Malformed("form past the end");
+    }
+    size_t end = position_ + size;
+    form_end_ = end;
+
+    // Reused by every load of the thread, forms are mostly small. Whatever a
+    // failed load left behind is dropped here.
+    static thread_local std::vector<Frame> stack;
+    // Elements of the open lists, innermost last.
+    static thread_local std::vector<AST> items;
+    stack.clear();
+    items.clear();
+    auto push = [&](Frame frame) {
+        if (stack.size() >= max_depth) {
+            throw SyntaxError("Syntax error: maximum nesting depth exceeded");
+        }
+        stack.push_back(frame);
+    };
+
+    while (true) {
+        AST value;
+        auto tag = static_cast<BinaryAstTag>(ReadByte(end));
+        switch (tag) {
+            case BinaryAstTag::kEmptyList:
+                break;
+            case BinaryAstTag::kFalse:
+                value = MakeBoolean(false);
+                break;
+            case BinaryAstTag::kTrue:
+                value = MakeBoolean(true);
+                break;
+            case BinaryAstTag::kInteger:
+                value = MakeNumber(UnZigZag(ReadVarint(end)));
+                break;
+            case BinaryAstTag::kBigInteger:
+                value = ReadBigInteger(end);
+                break;
+            case BinaryAstTag::kSymbol: {
+                uint64_t index = ReadVarint(end);
+                if (index >= symbols_.size()) {
+                    throw Malformed("bad symbol index");
+                }
+                value = Value::Unmanaged(symbols_[index]);
+                break;
+            }
+            case BinaryAstTag::kQuote:
+                push({Frame::Kind::kQuote});
+                continue;
+            case BinaryAstTag::kList:
+            case BinaryAstTag::kDottedList: {
+                uint64_t length = ReadVarint(end);
+                // Every element takes at least its tag byte.
+                if (length == 0 || length > end - position_) {
+                    throw Malformed("bad list length");
+                }
+                push({Frame::Kind::kList, items.size(), length, tag == BinaryAstTag::kDottedList});
+                continue;
+            }
+            default:
+                throw Malformed("unknown tag");
+        }
+
+        // A node is complete: hand it to the enclosing frames until one needs more.
+        while (true) {
+            if (stack.empty()) {
+                if (position_ != end) {
+                    throw Malformed("trailing bytes in form");
+                }
+                return value;
+            }
+            Frame& frame = stack.back();
+            if (frame.kind == Frame::Kind::kQuote) {
+                value = MakeQuote(std::move(value));
+            } else if (frame.kind == Frame::Kind::kTail) {
+                value = MakeList(std::span(items).subspan(frame.start), std::move(value));
+                items.resize(frame.start);
+            } else {
+                items.push_back(std::move(value));
+                if (--frame.remaining > 0) {
+                    break;
+                }
+                if (frame.dotted) {
+                    frame.kind = Frame::Kind::kTail;
+                    break;
+                }
+                value = MakeList(std::span(items).subspan(frame.start));
+                items.resize(frame.start);
+            }
+            stack.pop_back();
+        }
+    }
+}
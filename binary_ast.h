@@ -0,0 +1,103 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "parser.h"
+
+// Precompiled programs: the ASTs Read makes, serialized so that loading them
+// skips tokenizing and parsing. A file is
+//
+//   "SCMB" version:u8
+//   symbol count:varint, then per symbol  length:varint name bytes
+//   per top-level form  size:varint node bytes
+//
+// Varints are unsigned LEB128. A node is a tag byte and its payload:
+//
+//   kEmptyList, kFalse, kTrue      nothing
+//   kInteger                       zigzag varint, any int64_t
+//   kBigInteger                    varint limbs * 2 + negative, then the
+//                                  limbs of BigInteger, 4 bytes little endian
+//   kSymbol                        varint index into the symbol table
+//   kQuote                         the quoted node
+//   kList                          varint n > 0, then n element nodes
+//   kDottedList                    varint n > 0, n element nodes, the tail node
+//
+// Forms are prefixed with their size, so a form that fails to load is
+// skipped without decoding the rest of it.
+
+constexpr std::string_view kBinaryAstMagic = "SCMB";
+// Bumped on any change to the layout, a reader only accepts its own version.
+constexpr uint8_t kBinaryAstVersion = 1;
+
+enum class BinaryAstTag : uint8_t {
+    kEmptyList,
+    kFalse,
+    kTrue,
+    kInteger,
+    kBigInteger,
+    kSymbol,
+    kQuote,
+    kList,
+    kDottedList,
+};
+
+// True if `data` starts like a binary AST of any version.
+bool IsBinaryAst(std::string_view data);
+
+// Collects forms and lays them out with the symbols they use. Forms are
+// encoded as they are added, the AST need not outlive Add.
+class BinaryAstWriter {
+public:
+    void Add(const AST& form);
+
+    // The whole file: header, symbol table and every form added so far.
+    std::string Finish() const;
+
+private:
+    // Numbers, booleans, symbols and the empty list.
+    void WriteAtom(const AST& atom);
+    uint64_t GetSymbolIndex(const Symbol* symbol);
+
+    std::unordered_map<const Symbol*, uint64_t> symbol_indices_;
+    std::vector<const Symbol*> symbols_;
+    std::string forms_;
+    // The form being encoded, reused between forms.
+    std::string scratch_;
+};
+
+// Loads forms straight from `data`, typically the chunk of a
+// MappedFileSource: nodes are decoded in place and symbol names are interned
+// from the mapped bytes, nothing of the file is copied. Malformed input
+// raises SyntaxError, like malformed text.
+class BinaryAstReader {
+public:
+    // Checks the header and interns the symbol table. `data` must outlive
+    // the reader.
+    explicit BinaryAstReader(std::string_view data);
+
+    bool IsEnd() const {
+        return position_ == data_.size();
+    }
+
+    // The next form, nested at most max_depth deep.
+    AST Read(size_t max_depth = kDefaultMaxReadDepth);
+
+    // Moves past the form the last Read failed on.
+    void Skip() {
+        position_ = form_end_;
+    }
+
+private:
+    uint8_t ReadByte(size_t end);
+    uint64_t ReadVarint(size_t end);
+    AST ReadBigInteger(size_t end);
+
+    std::string_view data_;
+    size_t position_ = 0;
+    size_t form_end_ = 0;
+    std::vector<Symbol*> symbols_;
+};
@@ -0,0 +1,51 @@
+#include "budget.h"
+#include <algorithm>
+#include <limits>
+
+thread_local Budget* Budget::current = nullptr;
+
+Budget::Budget(const RunLimits& limits, MemoryStats* report)
+    : steps_left_(limits.max_steps ? limits.max_steps : std::numeric_limits<uint64_t>::max()),
+      max_nodes_(limits.max_nodes ? limits.max_nodes : std::numeric_limits<uint64_t>::max()),
+      max_bytes_(limits.max_bytes ? limits.max_bytes : std::numeric_limits<size_t>::max()),
+      report_(report),
+      deadline_(limits.timeout.count() ? std::chrono::steady_clock::now() + limits.timeout
+                                       : std::chrono::steady_clock::time_point::max()),
+      cancel_(limits.cancel) {
+    if (cancel_ && cancel_->IsCancelled()) {
+        throw LimitError("Limit error: cancelled");
+    }
+    ticks_ = std::min(steps_left_, kCheckInterval);
+    steps_left_ -= ticks_;
+}
+
+Budget::~Budget() {
+    if (report_) {
+        *report_ = memory_;
+    }
+}
+
+uint64_t Budget::Grant() {
+    ticks_ = 0;
+    if (steps_left_ == 0) {
+        throw LimitError("Limit error: out of evaluation steps");
+    }
+    if (cancel_ && cancel_->IsCancelled()) {
+        throw LimitError("Limit error: cancelled");
+    }
+    if (deadline_ != std::chrono::steady_clock::time_point::max() &&
+        std::chrono::steady_clock::now() >= deadline_) {
+        throw LimitError("Limit error: deadline exceeded");
+    }
+    uint64_t grant = std::min(steps_left_, kCheckInterval);
+    steps_left_ -= grant;
+    return grant;
+}
+
+BudgetScope::BudgetScope(Budget* budget) : previous_(Budget::current) {
+    Budget::current = budget;
+}
+
+BudgetScope::~BudgetScope() {
+    Budget::current = previous_;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+
+#include "error.h"
+
+// Set from any thread to stop the runs that watch it, see RunLimits::cancel.
+class CancellationToken {
+public:
+    void Cancel() {
+        cancelled_.store(true, std::memory_order_relaxed);
+    }
+    void Reset() {
+        cancelled_.store(false, std::memory_order_relaxed);
+    }
+    bool IsCancelled() const {
+        return cancelled_.load(std::memory_order_relaxed);
+    }
+
+private:
+    std::atomic<bool> cancelled_ = false;
+};
+
+// Bounds on one evaluation, zero leaves a limit off. Exceeding any of them
+// raises LimitError.
+struct RunLimits {
+    // Evaluation steps: one Apply in the tree-walker, one instruction in the VM.
+    uint64_t max_steps = 0;
+    // Wall-clock time from the start of the run.
+    std::chrono::nanoseconds timeout{0};
+    // Objects allocated, by the parser and the evaluator alike.
+    uint64_t max_nodes = 0;
+    // Bytes of objects alive at once. Checked before each allocation, so a
+    // run that would exceed it fails instead of growing the process.
+    size_t max_bytes = 0;
+    // Watched along with the deadline; must outlive the run.
+    const CancellationToken* cancel = nullptr;
+
+    bool IsBounded() const {
+        return max_steps || timeout.count() || max_nodes || max_bytes || cancel;
+    }
+};
+
+// Bytes of the objects one run allocated. Arena objects are only freed when
+// the run ends, so with an arena the peak is the total. Hash-consed objects
+// are charged to every run that asks for them and released by the run that
+// drops the last reference, so the peak may be overestimated, never under.
+struct MemoryStats {
+    size_t total_bytes = 0;
+    size_t peak_bytes = 0;
+};
+
+// What is left of the RunLimits of the run in progress on this thread. Steps
+// are counted down from an allowance; the clock and the token are only looked
+// at when it runs out, every kCheckInterval steps.
+class Budget {
+public:
+    static constexpr uint64_t kCheckInterval = 1024;
+
+    // Throws LimitError right away if the token is already cancelled. The
+    // memory used is written to *report, if given, when the budget is destroyed.
+    explicit Budget(const RunLimits& limits, MemoryStats* report = nullptr);
+    ~Budget();
+
+    Budget(const Budget&) = delete;
+    Budget& operator=(const Budget&) = delete;
+
+    void Step() {
+        if (ticks_-- == 0) [[unlikely]] {
+            ticks_ = Grant() - 1;
+        }
+    }
+
+    // For evaluators that count steps down in a local: hands over every step
+    // granted so far, or a new grant if none is left. Give back what is left
+    // unused with Return.
+    uint64_t Take() {
+        uint64_t ticks = ticks_;
+        ticks_ = 0;
+        return ticks ? ticks : Grant();
+    }
+    void Return(uint64_t ticks) {
+        ticks_ += ticks;
+    }
+
+    // Called before `count` objects of `bytes` in all are allocated.
+    void Charge(size_t bytes, uint64_t count) {
+        if (nodes_ + count > max_nodes_) [[unlikely]] {
+            throw LimitError("Limit error: too many objects allocated");
+        }
+        if (live_bytes_ + bytes > max_bytes_) [[unlikely]] {
+            throw LimitError("Limit error: memory limit exceeded");
+        }
+        nodes_ += count;
+        live_bytes_ += bytes;
+        memory_.total_bytes += bytes;
+        memory_.peak_bytes = std::max(memory_.peak_bytes, live_bytes_);
+    }
+    // Objects allocated before the run may die during it, hence the clamp.
+    void Release(size_t bytes) {
+        live_bytes_ -= std::min(live_bytes_, bytes);
+    }
+
+    const MemoryStats& GetMemoryStats() const {
+        return memory_;
+    }
+
+    // The budget objects allocated on this thread are charged to, if any.
+    static Budget* Current() {
+        return current;
+    }
+
+private:
+    friend class BudgetScope;
+
+    // Checks the deadline and the token, then returns the next allowance.
+    uint64_t Grant();
+
+    static thread_local Budget* current;
+
+    // Steps granted and not yet taken.
+    uint64_t ticks_;
+    // Steps not yet granted to ticks_.
+    uint64_t steps_left_;
+    uint64_t nodes_ = 0;
+    uint64_t max_nodes_;
+    size_t live_bytes_ = 0;
+    size_t max_bytes_;
+    MemoryStats memory_;
+    MemoryStats* report_;
+    std::chrono::steady_clock::time_point deadline_;
+    const CancellationToken* cancel_;
+};
+
+// Charges the evaluation and allocations of the current thread to `budget`
+// until the scope ends, nullptr runs unbounded.
+class BudgetScope {
+public:
+    explicit BudgetScope(Budget* budget);
+    ~BudgetScope();
+
+    BudgetScope(const BudgetScope&) = delete;
+    BudgetScope& operator=(const BudgetScope&) = delete;
+
+private:
+    Budget* previous_;
+};
+
+// Charges `count` new objects of `bytes` in all to the current budget, if any.
+inline void ChargeAllocation(size_t bytes, uint64_t count = 1) {
+    if (Budget* budget = Budget::Current()) {
+        budget->Charge(bytes, count);
+    }
+}
+
+inline void ReleaseAllocation(size_t bytes) {
+    if (Budget* budget = Budget::Current()) {
+        budget->Release(bytes);
+    }
+}
@@ -0,0 +1,334 @@
+#include "builtins.h"
+#include <array>
+#include <functional>
+#include <string>
+#include <utility>
+
+// Builtins are written as plain functions of their arguments. The templates
+// below read the arity and the argument type off the signature and adapt the
+// function to the Kernel calling convention: NumberArg parameters declare
+// number arguments, const AST& parameters accept any value.
+
+// A number argument, either a fixnum or a boxed BigInteger.
+struct NumberArg {
+    const AST& value;
+};
+
+template <class T>
+static constexpr bool kIsNumber = std::is_same_v<std::decay_t<T>, NumberArg>;
+
+// Values are passed by reference, copying one would touch its reference count.
+template <class T>
+static decltype(auto) Unwrap(const AST& value) {
+    if constexpr (kIsNumber<T>) {
+        return NumberArg{value};
+    } else {
+        return (value);
+    }
+}
+
+static AST Wrap(AST value) {
+    return value;
+}
+
+static AST Wrap(bool value) {
+    return MakeBoolean(value);
+}
+
+template <auto kFunction>
+struct Signature;
+
+template <class Result, class... Args, Result (*kFunction)(Args...)>
+struct Signature<kFunction> {
+    static_assert((kIsNumber<Args> && ...) || (!kIsNumber<Args> && ...),
+                  "all arguments of a builtin have the same type");
+
+    static AST Call(std::span<const AST> args) {
+        return [args]<size_t... kIndex>(std::index_sequence<kIndex...>) {
+            return Wrap(kFunction(Unwrap<Args>(args[kIndex])...));
+        }(std::index_sequence_for<Args...>());
+    }
+
+    static constexpr size_t kArity = sizeof...(Args);
+    static constexpr ArgType kArgType =
+        sizeof...(Args) > 0 && (kIsNumber<Args> && ...) ? ArgType::kNumber : ArgType::kAny;
+};
+
+// A builtin taking exactly the arguments of kFunction.
+template <auto kFunction>
+static constexpr Builtin Fixed(const char* name) {
+    using Traits = Signature<kFunction>;
+    return {name,           BuiltinKind::kEager, Traits::kArity, Traits::kArity,
+            Traits::kArgType, Traits::Call};
+}
+
+// A fold runs on int64_t while its operands are fixnums and no step
+// overflows, which is the common case. Otherwise the step reports it and the
+// rest of the fold goes on with the BigInteger step.
+using Step = bool (*)(int64_t acc, int64_t value, int64_t* result);
+using BigStep = void (*)(BigInteger* acc, const BigInteger& value);
+
+// Kept out of line, so that the int64_t loop does not carry its cleanup.
+template <BigStep kBigStep>
+[[gnu::noinline]] static AST FoldBig(BigInteger acc, std::span<const AST> args) {
+    for (const AST& arg : args) {
+        kBigStep(&acc, arg.GetBigInteger());
+    }
+    return MakeNumber(std::move(acc));
+}
+
+template <Step kStep, BigStep kBigStep>
+static AST Fold(int64_t acc, std::span<const AST> args) {
+    for (size_t i = 0; i < args.size(); ++i) {
+        int64_t next;
+        if (!args[i].IsFixnum() || !kStep(acc, args[i].GetNumber(), &next)) {
+            return FoldBig<kBigStep>(BigInteger(acc), args.subspan(i));
+        }
+        acc = next;
+    }
+    return MakeNumber(acc);
+}
+
+template <int64_t kInit, Step kStep, BigStep kBigStep>
+static AST FoldAll(std::span<const AST> args) {
+    return Fold<kStep, kBigStep>(kInit, args);
+}
+
+template <Step kStep, BigStep kBigStep>
+static AST FoldRest(std::span<const AST> args) {
+    if (!args[0].IsFixnum()) {
+        return FoldBig<kBigStep>(args[0].GetBigInteger(), args.subspan(1));
+    }
+    return Fold<kStep, kBigStep>(args[0].GetNumber(), args.subspan(1));
+}
+
+// Variadic numeric builtins folding their arguments from the left, either
+// starting from kInit or from their first argument.
+template <int64_t kInit, Step kStep, BigStep kBigStep>
+static constexpr Builtin FoldFrom(const char* name) {
+    return {name, BuiltinKind::kEager, 0, Builtin::kVariadic, ArgType::kNumber,
+            FoldAll<kInit, kStep, kBigStep>};
+}
+
+template <Step kStep, BigStep kBigStep>
+static constexpr Builtin FoldFirst(const char* name, size_t min_args) {
+    return {name, BuiltinKind::kEager, min_args, Builtin::kVariadic, ArgType::kNumber,
+            FoldRest<kStep, kBigStep>};
+}
+
+// The whole comparison family shares this kernel, specialized per operator.
+template <class Compare>
+static bool CompareWith(int64_t lhs, int64_t rhs) {
+    return Compare()(lhs, rhs);
+}
+
+template <class Compare>
+static constexpr Builtin Comparison(const char* name) {
+    return {name,    BuiltinKind::kCompare, 0, Builtin::kVariadic, ArgType::kNumber,
+            nullptr, CompareWith<Compare>};
+}
+
+// Integer
+static bool IsNumber(const AST& value) {
+    return Is<Number>(value);
+}
+
+static bool Add(int64_t acc, int64_t value, int64_t* result) {
+    return !__builtin_add_overflow(acc, value, result);
+}
+
+static void AddBig(BigInteger* acc, const BigInteger& value) {
+    *acc = *acc + value;
+}
+
+static bool Subtract(int64_t acc, int64_t value, int64_t* result) {
+    return !__builtin_sub_overflow(acc, value, result);
+}
+
+static void SubtractBig(BigInteger* acc, const BigInteger& value) {
+    *acc = *acc - value;
+}
+
+static bool Multiply(int64_t acc, int64_t value, int64_t* result) {
+    return !__builtin_mul_overflow(acc, value, result);
+}
+
+static void MultiplyBig(BigInteger* acc, const BigInteger& value) {
+    *acc = *acc * value;
+}
+
+[[noreturn]] static void ThrowDivisionByZero() {
+    throw RuntimeError("Runtime error: catched 0 in /");
+}
+
+static bool Divide(int64_t acc, int64_t value, int64_t* result) {
+    if (value == 0) {
+        ThrowDivisionByZero();
+    }
+    // The one quotient that does not fit.
+    if (acc == std::numeric_limits<int64_t>::min() && value == -1) {
+        return false;
+    }
+    *result = acc / value;
+    return true;
+}
+
+static void DivideBig(BigInteger* acc, const BigInteger& value) {
+    if (value.IsZero()) {
+        ThrowDivisionByZero();
+    }
+    *acc = *acc / value;
+}
+
+static bool Min(int64_t acc, int64_t value, int64_t* result) {
+    *result = std::min(acc, value);
+    return true;
+}
+
+static void MinBig(BigInteger* acc, const BigInteger& value) {
+    if (Compare(value, *acc) < 0) {
+        *acc = value;
+    }
+}
+
+static bool Max(int64_t acc, int64_t value, int64_t* result) {
+    *result = std::max(acc, value);
+    return true;
+}
+
+static void MaxBig(BigInteger* acc, const BigInteger& value) {
+    if (Compare(value, *acc) > 0) {
+        *acc = value;
+    }
+}
+
+static AST Abs(NumberArg number) {
+    if (number.value.IsFixnum()) {
+        return MakeNumber(std::abs(number.value.GetNumber()));
+    }
+    return MakeNumber(number.value.GetBigInteger().Abs());
+}
+
+// Boolean
+static bool IsBoolean(const AST& value) {
+    return Is<Boolean>(value);
+}
+
+static bool Not(const AST& value) {
+    return Is<Boolean>(value) && !value.GetBoolean();
+}
+
+// List
+static bool IsList(const AST& value) {
+    return IsProperList(value);
+}
+
+static bool IsNull(const AST& value) {
+    return value == nullptr;
+}
+
+static bool IsPair(const AST& value) {
+    if (!Is<Cell>(value)) {
+        return false;
+    }
+    auto cell = As<Cell>(value);
+    return (cell->GetFirst() != nullptr) && (cell->GetSecond() != nullptr);
+}
+
+static AST Cons(const AST& first, const AST& second) {
+    return MakeCell(first, second);
+}
+
+static AST Car(const AST& list) {
+    if (list == nullptr || !Is<Cell>(list)) {
+        throw RuntimeError("Runtime error: car expected not empty list");
+    }
+    return As<Cell>(list)->GetFirst();
+}
+
+static AST Cdr(const AST& list) {
+    if (list == nullptr || !Is<Cell>(list)) {
+        throw RuntimeError("Runtime error: cdr expected not empty list");
+    }
+    return As<Cell>(list)->GetSecond();
+}
+
+static size_t GetListIndex(const AST& list, const AST& index, const char* name) {
+    if (!IsProperList(list) || list == nullptr) {
+        throw RuntimeError(std::string("Runtime error: ") + name + " catched invalid list");
+    }
+    if (!Is<Number>(index) ||
+        (index.IsFixnum() ? index.GetNumber() < 0 : As<Number>(index)->GetValue().IsNegative())) {
+        throw RuntimeError(std::string("Runtime error: invalid index in ") + name);
+    }
+    // A boxed index is past the end of any list.
+    return index.IsFixnum() ? index.GetNumber() : std::numeric_limits<size_t>::max();
+}
+
+static AST ListRef(const AST& list, const AST& index) {
+    size_t steps = GetListIndex(list, index, "list-ref");
+    const AST& rest = SkipCells(list, &steps);
+    if (rest == nullptr) {
+        throw RuntimeError("Runtime error: index out of range in list-ref");
+    }
+    return As<Cell>(rest)->GetFirst();
+}
+
+static AST ListTail(const AST& list, const AST& index) {
+    size_t steps = GetListIndex(list, index, "list-tail");
+    const AST& rest = SkipCells(list, &steps);
+    if (steps > 0) {
+        throw RuntimeError("Runtime error: index out of range in list-tail");
+    }
+    return rest;
+}
+
+static constexpr size_t kVariadic = Builtin::kVariadic;
+
+static const std::array kBuiltins = {
+    Fixed<IsNumber>("number?"),
+    FoldFrom<0, Add, AddBig>("+"),
+    FoldFirst<Subtract, SubtractBig>("-", 1),
+    FoldFrom<1, Multiply, MultiplyBig>("*"),
+    FoldFirst<Divide, DivideBig>("/", 2),
+    FoldFirst<Max, MaxBig>("max", 1),
+    FoldFirst<Min, MinBig>("min", 1),
+    Fixed<Abs>("abs"),
+    Comparison<std::equal_to<int64_t>>("="),
+    Comparison<std::less<int64_t>>("<"),
+    Comparison<std::greater<int64_t>>(">"),
+    Comparison<std::less_equal<int64_t>>("<="),
+    Comparison<std::greater_equal<int64_t>>(">="),
+    Fixed<IsBoolean>("boolean?"),
+    Fixed<Not>("not"),
+    Builtin{"and", BuiltinKind::kAnd, 0, kVariadic},
+    Builtin{"or", BuiltinKind::kOr, 0, kVariadic},
+    Fixed<IsList>("list?"),
+    Fixed<IsNull>("null?"),
+    Fixed<IsPair>("pair?"),
+    Fixed<Cons>("cons"),
+    Fixed<Car>("car"),
+    Fixed<Cdr>("cdr"),
+    Builtin{"list", BuiltinKind::kList, 0, kVariadic},
+    Fixed<ListRef>("list-ref"),
+    Fixed<ListTail>("list-tail")};
+
+void ThrowArgumentType(const Builtin& builtin) {
+    throw RuntimeError(std::string("Runtime error: expected number in ") + builtin.name);
+}
+
+const Builtin* FindBuiltin(const Symbol& symbol) {
+    return symbol.GetId() < kBuiltins.size() ? &kBuiltins[symbol.GetId()] : nullptr;
+}
+
+const Builtin& GetBuiltin(uint32_t id) {
+    return kBuiltins[id];
+}
+
+uint32_t GetBuiltinCount() {
+    return kBuiltins.size();
+}
+
+uint32_t GetBuiltinId(const Builtin* builtin) {
+    return static_cast<uint32_t>(builtin - kBuiltins.data());
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#include "parser.h"
+#include <limits>
+#include <span>
+
+// Builtin table shared by both evaluators. Eager builtins receive their
+// already evaluated arguments, the other kinds control the evaluation of
+// their operands and are lowered by the compiler into dedicated instructions.
+// Each builtin declares its arity and the type of its arguments, so callers
+// validate a call the same way before any kernel runs.
+
+enum class BuiltinKind { kEager, kCompare, kAnd, kOr, kList };
+
+// Type every argument of a builtin must have.
+enum class ArgType { kAny, kNumber };
+
+using Kernel = AST (*)(std::span<const AST> args);
+// Orders two fixnums; boxed numbers are ordered by the sign of their
+// BigInteger comparison instead, see CompareNumbers.
+using Comparator = bool (*)(int64_t lhs, int64_t rhs);
+
+struct Builtin {
+    static constexpr size_t kVariadic = std::numeric_limits<size_t>::max();
+
+    const char* name;
+    BuiltinKind kind;
+    size_t min_args;
+    size_t max_args;
+    ArgType arg_type = ArgType::kAny;
+    Kernel kernel = nullptr;
+    Comparator comparator = nullptr;
+};
+
+[[noreturn]] void ThrowArgumentType(const Builtin& builtin);
+
+// Kernels read their number arguments unchecked, the caller runs this first.
+inline void CheckArgumentTypes(const Builtin& builtin, std::span<const AST> args) {
+    if (builtin.arg_type == ArgType::kNumber) {
+        for (const AST& arg : args) {
+            if (!Is<Number>(arg)) {
+                ThrowArgumentType(builtin);
+            }
+        }
+    }
+}
+
+// Applies the comparator of a kCompare builtin to two numbers.
+inline bool CompareNumbers(const Builtin& builtin, const AST& lhs, const AST& rhs) {
+    if (lhs.IsFixnum() && rhs.IsFixnum()) {
+        return builtin.comparator(lhs.GetNumber(), rhs.GetNumber());
+    }
+    return builtin.comparator(Compare(lhs.GetBigInteger(), rhs.GetBigInteger()), 0);
+}
+
+// Builtin symbols are interned first, so a symbol id below GetBuiltinCount()
+// is the slot of its builtin and resolving an operator needs no hashing.
+const Builtin* FindBuiltin(const Symbol& symbol);
+
+const Builtin& GetBuiltin(uint32_t id);
+
+uint32_t GetBuiltinCount();
+
+uint32_t GetBuiltinId(const Builtin* builtin);
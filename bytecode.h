@@ -0,0 +1,60 @@
+#pragma once
+
+#include "parser.h"
+#include <span>
+#include <vector>
+
+// Flat instruction stream produced by Compile() and executed by VirtualMachine.
+// Every expression leaves exactly one value on the stack.
+
+enum class OpCode : uint8_t {
+    kPushConstant,  // push constants[arg], also used for quoted literals
+    kCallBuiltin,   // pop count values, push GetBuiltin(arg).kernel(values)
+    kJumpIfFalse,   // keep #f on the stack and jump to arg, otherwise pop
+    kJumpIfTrue,    // keep a true value on the stack and jump to arg, otherwise pop
+    kCheckNumber,   // fail unless the top of the stack is a number, count is the builtin
+    kCompare,       // pop rhs, compare with lhs on top; on mismatch replace with #f and jump
+    kPop,
+    kFail,          // throw RuntimeError(messages[arg])
+    kDispatch,      // pop an evaluated operator, apply it to the operands in constants[arg],
+                    // with the slots bound first if count is 1
+    kPushArgument,  // push the value bound to slots[arg]
+    kPushTemplate,  // push constants[arg] with the values bound to its slots
+    kCountCall,     // count a call of GetBuiltin(arg), which runs no kernel, see Compile
+};
+
+struct Instruction {
+    OpCode code;
+    uint32_t arg = 0;
+    uint32_t count = 0;
+};
+
+struct Program {
+    std::vector<Instruction> code;
+    std::vector<AST> constants;
+    std::vector<std::string> messages;
+    // Symbols that stand for the arguments of VirtualMachine::Run, in order.
+    std::vector<const Symbol*> slots;
+};
+
+struct Builtin;
+
+// Bounds both the nesting of the compiled expressions and the number of calls
+// the VM dispatches at runtime, exceeding it raises RuntimeError.
+constexpr size_t kDefaultMaxDepth = 100000;
+
+// Every occurrence of a symbol of `slots` is compiled as a reference to the
+// argument of the same index, quoted data included. With count_calls, the
+// builtins that run no kernel (and, or, comparisons, list) count their calls
+// in the Metrics of the run; without, they cost nothing extra.
+Program Compile(AST ast, size_t max_depth = kDefaultMaxDepth,
+                std::span<const Symbol* const> slots = {}, bool count_calls = false);
+
+// Lowers the application of builtin to its unevaluated operands, used for
+// calls whose operator is only known at runtime.
+Program CompileCall(const Builtin& builtin, AST operands, size_t max_depth = kDefaultMaxDepth,
+                    bool count_calls = false);
+
+// A copy of `value` with every symbol of `slots` replaced by the argument of
+// the same index, as if its text had been written there.
+AST BindSlots(const AST& value, std::span<const Symbol* const> slots, std::span<const AST> args);
@@ -0,0 +1,375 @@
+#include "bytecode.h"
+#include "builtins.h"
+#include "arena.h"
+#include <algorithm>
+
+// Lowers an AST without native recursion: pending work is kept on an explicit
+// stack of tasks, so deeply nested input cannot overflow the C++ stack.
+class Compiler {
+    static constexpr uint32_t kNoJump = UINT32_MAX;
+
+public:
+    Compiler(size_t max_depth, std::span<const Symbol* const> slots, bool count_calls)
+        : max_depth_(max_depth), count_calls_(count_calls) {
+        program_.slots.assign(slots.begin(), slots.end());
+    }
+
+    Program Compile(const AST& ast) {
+        Append(Task::Expression(&ast, 0));
+        Schedule();
+        Drain();
+        return std::move(program_);
+    }
+
+    Program CompileCall(const Builtin& builtin, const AST& operands) {
+        CompileArguments(builtin, operands, 0);
+        Schedule();
+        Drain();
+        return std::move(program_);
+    }
+
+private:
+    struct Task {
+        enum class Kind { kExpression, kInstruction, kJump, kPatchJumps };
+
+        // The expression stays owned by the AST being compiled.
+        static Task Expression(const AST* ast, size_t depth) {
+            return {Kind::kExpression, ast, {}, depth};
+        }
+        static Task Emit(OpCode code, uint32_t arg = 0, uint32_t count = 0) {
+            return {Kind::kInstruction, nullptr, {code, arg, count}, 0};
+        }
+        // Jumps of a group all target the position of its kPatchJumps task.
+        static Task Jump(OpCode code, size_t group, uint32_t count = 0) {
+            return {Kind::kJump, nullptr, {code, 0, count}, group};
+        }
+        static Task PatchJumps(size_t group) {
+            return {Kind::kPatchJumps, nullptr, {}, group};
+        }
+
+        Kind kind;
+        const AST* ast;
+        Instruction instruction;
+        size_t depth_or_group;
+    };
+
+    // The tasks of one expression are appended in execution order on top of
+    // the stack, then reversed so that they are popped in that order.
+    void Append(Task task) {
+        tasks_.push_back(task);
+    }
+
+    void Discard() {
+        tasks_.resize(sequence_start_);
+    }
+
+    void Schedule() {
+        std::reverse(tasks_.begin() + sequence_start_, tasks_.end());
+    }
+
+    void Drain() {
+        while (!tasks_.empty()) {
+            Task task = tasks_.back();
+            tasks_.pop_back();
+            sequence_start_ = tasks_.size();
+            switch (task.kind) {
+                case Task::Kind::kExpression:
+                    CompileExpression(*task.ast, task.depth_or_group);
+                    break;
+                case Task::Kind::kInstruction:
+                    program_.code.push_back(task.instruction);
+                    break;
+                case Task::Kind::kJump:
+                    // Until patched, the jumps of a group are chained through their arg.
+                    task.instruction.arg = jump_chains_[task.depth_or_group];
+                    jump_chains_[task.depth_or_group] = program_.code.size();
+                    program_.code.push_back(task.instruction);
+                    break;
+                case Task::Kind::kPatchJumps:
+                    for (uint32_t jump = jump_chains_[task.depth_or_group]; jump != kNoJump;) {
+                        uint32_t next = program_.code[jump].arg;
+                        program_.code[jump].arg = program_.code.size();
+                        jump = next;
+                    }
+                    break;
+            }
+        }
+    }
+
+    uint32_t AddConstant(AST value) {
+        program_.constants.push_back(std::move(value));
+        return program_.constants.size() - 1;
+    }
+
+    // Index of the slot `ast` is, or -1.
+    int64_t FindSlot(const AST& ast) const {
+        const auto& slots = program_.slots;
+        if (slots.empty() || !Is<Symbol>(ast)) {
+            return -1;
+        }
+        auto it = std::find(slots.begin(), slots.end(), As<Symbol>(ast));
+        return it != slots.end() ? it - slots.begin() : -1;
+    }
+
+    bool HasSlots(const AST& ast) const {
+        if (program_.slots.empty()) {
+            return false;
+        }
+        std::vector<const AST*> pending = {&ast};
+        while (!pending.empty()) {
+            const AST& value = *pending.back();
+            pending.pop_back();
+            if (Is<Quote>(value)) {
+                pending.push_back(&As<Quote>(value)->GetCommand());
+            } else if (Is<Cell>(value)) {
+                pending.push_back(&As<Cell>(value)->GetSecond());
+                pending.push_back(&As<Cell>(value)->GetFirst());
+            } else if (FindSlot(value) >= 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    Task PushConstant(AST value) {
+        if (HasSlots(value)) {
+            return Task::Emit(OpCode::kPushTemplate, AddConstant(std::move(value)));
+        }
+        return Task::Emit(OpCode::kPushConstant, AddConstant(std::move(value)));
+    }
+
+    // Errors are raised when the failing expression is reached, not at compile time:
+    // an ill-formed argument of 'and'/'or' must not fire if it is short-circuited.
+    Task Fail(std::string message) {
+        program_.messages.push_back(std::move(message));
+        return Task::Emit(OpCode::kFail, program_.messages.size() - 1);
+    }
+
+    size_t NewJumpGroup() {
+        jump_chains_.push_back(kNoJump);
+        return jump_chains_.size() - 1;
+    }
+
+    void CompileExpression(const AST& ast, size_t depth) {
+        if (depth > max_depth_) {
+            throw RuntimeError("Runtime error: maximum nesting depth exceeded");
+        }
+        if (ast == nullptr) {
+            Append(Fail("Runtime error: empty command"));
+        } else if (Is<Quote>(ast)) {
+            Append(PushConstant(As<Quote>(ast)->GetCommand()));
+        } else if (Is<Cell>(ast)) {
+            CompileApplication(As<Cell>(ast), depth);
+        } else if (int64_t slot = FindSlot(ast); slot >= 0) {
+            Append(Task::Emit(OpCode::kPushArgument, slot));
+        } else {
+            Append(PushConstant(ast));
+        }
+        Schedule();
+    }
+
+    void CompileApplication(const Cell* cell, size_t depth) {
+        const AST& operation = cell->GetFirst();
+        if (Is<Quote>(operation) || Is<Cell>(operation) || FindSlot(operation) >= 0) {
+            // The operation is only known after evaluation, the VM compiles the call then.
+            Append(Task::Expression(&operation, depth + 1));
+            Append(Task::Emit(OpCode::kDispatch, AddConstant(cell->GetSecond()),
+                              HasSlots(cell->GetSecond())));
+            return;
+        }
+        if (!Is<Symbol>(operation)) {
+            Append(Fail("Runtime Error: incorrect operation"));
+            return;
+        }
+        const Builtin* builtin = FindBuiltin(*As<Symbol>(operation));
+        if (!builtin) {
+            Append(Fail("Runtime error: unknown command"));
+            return;
+        }
+        CompileArguments(*builtin, cell->GetSecond(), depth);
+    }
+
+    void CompileArguments(const Builtin& builtin, const AST& operands, size_t depth) {
+        if (count_calls_ && builtin.kind != BuiltinKind::kEager) {
+            // Runs no kernel, so it is counted where it starts instead.
+            Append(Task::Emit(OpCode::kCountCall, GetBuiltinId(&builtin)));
+        }
+        switch (builtin.kind) {
+            case BuiltinKind::kEager:
+                CompileEager(builtin, operands, depth);
+                break;
+            case BuiltinKind::kCompare:
+                CompileCompare(builtin, operands, depth);
+                break;
+            case BuiltinKind::kAnd:
+                CompileShortCircuit(OpCode::kJumpIfFalse, operands, depth, true);
+                break;
+            case BuiltinKind::kOr:
+                CompileShortCircuit(OpCode::kJumpIfTrue, operands, depth, false);
+                break;
+            case BuiltinKind::kList:
+                Append(PushConstant(operands));
+                break;
+        }
+    }
+
+    void CompileEager(const Builtin& builtin, const AST& operands, size_t depth) {
+        size_t count = 0;
+        const AST* operand = &operands;
+        for (; Is<Cell>(*operand); operand = &As<Cell>(*operand)->GetSecond()) {
+            Append(Task::Expression(&As<Cell>(*operand)->GetFirst(), depth + 1));
+            ++count;
+        }
+        if (*operand != nullptr) {
+            Discard();
+            Append(Fail(std::string("Runtime error: expected expression in ") + builtin.name));
+            return;
+        }
+        if (count < builtin.min_args || count > builtin.max_args) {
+            Discard();
+            Append(
+                Fail(std::string("Runtime error: wrong number of arguments in ") + builtin.name));
+            return;
+        }
+        Append(Task::Emit(OpCode::kCallBuiltin, GetBuiltinId(&builtin), count));
+    }
+
+    void CompileShortCircuit(OpCode jump, const AST& operands, size_t depth, bool empty_value) {
+        if (operands == nullptr) {
+            Append(PushConstant(MakeBoolean(empty_value)));
+            return;
+        }
+        size_t group = NewJumpGroup();
+        for (const AST* operand = &operands; *operand;) {
+            if (!Is<Cell>(*operand)) {
+                Append(Fail("Runtime error: and expects expression"));
+                break;
+            }
+            Append(Task::Expression(&As<Cell>(*operand)->GetFirst(), depth + 1));
+            operand = &As<Cell>(*operand)->GetSecond();
+            if (*operand) {
+                Append(Task::Jump(jump, group));
+            }
+        }
+        Append(Task::PatchJumps(group));
+    }
+
+    // (< a b c) keeps the last compared value on the stack and stops at the
+    // first failed comparison, so the remaining arguments are never evaluated.
+    void CompileCompare(const Builtin& builtin, const AST& operands, size_t depth) {
+        uint32_t id = GetBuiltinId(&builtin);
+        size_t group = NewJumpGroup();
+        bool proper = true;
+        const AST* operand = &operands;
+        for (bool first = true; *operand; first = false) {
+            if (!Is<Cell>(*operand)) {
+                Append(Fail(std::string("Runtime error: expected expression in ") + builtin.name));
+                proper = false;
+                break;
+            }
+            Append(Task::Expression(&As<Cell>(*operand)->GetFirst(), depth + 1));
+            if (first) {
+                Append(Task::Emit(OpCode::kCheckNumber, 0, id));
+            } else {
+                Append(Task::Jump(OpCode::kCompare, group, id));
+            }
+            operand = &As<Cell>(*operand)->GetSecond();
+            if (!*operand) {
+                Append(Task::Emit(OpCode::kPop));
+            }
+        }
+        if (proper) {
+            Append(PushConstant(MakeBoolean(true)));
+        }
+        Append(Task::PatchJumps(group));
+    }
+
+    size_t max_depth_;
+    bool count_calls_;
+    Program program_;
+    std::vector<Task> tasks_;
+    size_t sequence_start_ = 0;
+    // Last emitted jump of every group, kNoJump ends a chain.
+    std::vector<uint32_t> jump_chains_;
+};
+
+Program Compile(AST ast, size_t max_depth, std::span<const Symbol* const> slots,
+                bool count_calls) {
+    return Compiler(max_depth, slots, count_calls).Compile(ast);
+}
+
+Program CompileCall(const Builtin& builtin, AST operands, size_t max_depth, bool count_calls) {
+    return Compiler(max_depth, {}, count_calls).CompileCall(builtin, operands);
+}
+
+// Rebuilt bottom-up without native recursion, like Read builds its input.
+AST BindSlots(const AST& value, std::span<const Symbol* const> slots, std::span<const AST> args) {
+    // A quote or list being copied. `rest` is the part of the list after the
+    // element being copied, or its tail once that is being copied.
+    struct Frame {
+        bool quote;
+        bool tail;
+        const AST* rest;
+        size_t start;
+    };
+    // Reused by every call of the thread, whatever a failed copy left
+    // behind is dropped here.
+    static thread_local std::vector<Frame> stack;
+    // Copied elements of the open lists, innermost last.
+    static thread_local std::vector<AST> items;
+    stack.clear();
+    items.clear();
+    const AST* next = &value;
+    while (true) {
+        if (Is<Quote>(*next)) {
+            stack.push_back({true, false, nullptr, 0});
+            next = &As<Quote>(*next)->GetCommand();
+            continue;
+        }
+        if (Is<Cell>(*next)) {
+            stack.push_back({false, false, &As<Cell>(*next)->GetSecond(), items.size()});
+            next = &As<Cell>(*next)->GetFirst();
+            continue;
+        }
+        AST copy = *next;
+        if (Is<Symbol>(copy)) {
+            auto it = std::find(slots.begin(), slots.end(), As<Symbol>(copy));
+            if (it != slots.end()) {
+                copy = args[it - slots.begin()];
+            }
+        }
+        // Arena cells must not point to counted objects, see Arena.
+        if (Arena::Current() && Is<Number>(copy) && !copy.IsFixnum()) {
+            copy = MakeNumber(copy.GetBigInteger());
+        }
+
+        // A copy is complete: hand it to the enclosing frames until one needs more.
+        while (true) {
+            if (stack.empty()) {
+                return copy;
+            }
+            Frame& frame = stack.back();
+            if (frame.quote) {
+                copy = MakeQuote(std::move(copy));
+            } else if (frame.tail) {
+                copy = MakeList(std::span(items).subspan(frame.start), std::move(copy));
+                items.resize(frame.start);
+            } else {
+                items.push_back(std::move(copy));
+                if (Is<Cell>(*frame.rest)) {
+                    next = &As<Cell>(*frame.rest)->GetFirst();
+                    frame.rest = &As<Cell>(*frame.rest)->GetSecond();
+                    break;
+                }
+                if (*frame.rest != nullptr) {
+                    frame.tail = true;
+                    next = frame.rest;
+                    break;
+                }
+                copy = MakeList(std::span(items).subspan(frame.start));
+                items.resize(frame.start);
+            }
+            stack.pop_back();
+        }
+    }
+}
@@ -0,0 +1,90 @@
+#include "cons_table.h"
+
+thread_local bool ConsTable::enabled = false;
+
+ConsTable& ConsTable::Instance() {
+    static ConsTable table;
+    return table;
+}
+
+// A dying entry, whose count is already zero, is replaced rather than revived;
+// Forget then leaves the new entry alone.
+template <class Map, class Key, class Make>
+Value ConsTable::Intern(Map* map, const Key& key, Make make) {
+    std::lock_guard lock(mutex_);
+    auto [it, inserted] = map->try_emplace(key, nullptr);
+    if (!inserted) {
+        if (Value existing = Value::TryRetain(it->second)) {
+            return existing;
+        }
+    }
+    Object* object = make();
+    object->interned_ = true;
+    it->second = object;
+    return Value(object);
+}
+
+Value ConsTable::MakeCell(Value first, Value second) {
+    if (!IsCanonical(first) || !IsCanonical(second)) {
+        return Value(new Cell(std::move(first), std::move(second)));
+    }
+    auto key = std::make_pair(first.GetWord(), second.GetWord());
+    return Instance().Intern(&Instance().cells_, key, [&] {
+        return new Cell(std::move(first), std::move(second));
+    });
+}
+
+Value ConsTable::MakeQuote(Value cmd) {
+    if (!IsCanonical(cmd)) {
+        return Value(new Quote(std::move(cmd)));
+    }
+    uint64_t key = cmd.GetWord();
+    return Instance().Intern(&Instance().quotes_, key, [&] { return new Quote(std::move(cmd)); });
+}
+
+Value ConsTable::MakeBoxedNumber(BigInteger value) {
+    return Instance().Intern(&Instance().numbers_, value, [&] {
+        return new (value.GetLimbs().size()) Number(value.IsNegative(), value.GetLimbs());
+    });
+}
+
+void ConsTable::Forget(Object* object) {
+    ConsTable& table = Instance();
+    std::lock_guard lock(table.mutex_);
+    auto erase = [object](auto* map, const auto& key) {
+        auto it = map->find(key);
+        if (it != map->end() && it->second == object) {
+            map->erase(it);
+        }
+    };
+    switch (object->GetType()) {
+        case ObjectType::kCell: {
+            auto cell = static_cast<const Cell*>(object);
+            erase(&table.cells_,
+                  std::make_pair(cell->GetFirst().GetWord(), cell->GetSecond().GetWord()));
+            break;
+        }
+        case ObjectType::kQuote:
+            erase(&table.quotes_, static_cast<const Quote*>(object)->GetCommand().GetWord());
+            break;
+        case ObjectType::kNumber:
+            erase(&table.numbers_, static_cast<const Number*>(object)->GetValue());
+            break;
+        default:
+            break;
+    }
+}
+
+size_t ConsTable::GetSize() {
+    ConsTable& table = Instance();
+    std::lock_guard lock(table.mutex_);
+    return table.cells_.size() + table.quotes_.size() + table.numbers_.size();
+}
+
+HashConsScope::HashConsScope(bool enabled) : previous_(ConsTable::enabled) {
+    ConsTable::enabled = enabled;
+}
+
+HashConsScope::~HashConsScope() {
+    ConsTable::enabled = previous_;
+}
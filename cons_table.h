@@ -0,0 +1,77 @@
+#pragma once
+
+#include "object.h"
+#include <mutex>
+#include <unordered_map>
+
+// Process-wide weak table of hash-consed objects. While a HashConsScope is
+// enabled on a thread, MakeCell, MakeQuote and MakeBoxedNumber return the
+// existing object with the same contents if there is one, so identical
+// subtrees are stored once and compare equal by pointer. The table does not
+// own its entries: an interned object is dropped from it when it dies.
+//
+// An object is canonical if it is the empty list, an immediate, a symbol or
+// an interned object. Only objects whose children are canonical are interned,
+// so a canonical value is equal to another canonical value only if both are
+// the same word. Objects taken from an arena are never interned.
+class ConsTable {
+public:
+    static Value MakeCell(Value first, Value second);
+    static Value MakeQuote(Value cmd);
+    static Value MakeBoxedNumber(BigInteger value);
+
+    // Removes a dying interned object, called right before it is deleted.
+    static void Forget(Object* object);
+
+    static bool IsCanonical(const Value& value) {
+        if (value == nullptr || value.IsFixnum() || value.IsBoolean()) {
+            return true;
+        }
+        Object* object = value.GetObject();
+        return object->IsInterned() || object->GetType() == ObjectType::kSymbol;
+    }
+
+    // Whether the calling thread hash-conses the objects it makes.
+    static bool IsEnabled() {
+        return enabled;
+    }
+
+    // Number of live interned objects.
+    static size_t GetSize();
+
+private:
+    friend class HashConsScope;
+
+    struct WordPairHash {
+        size_t operator()(const std::pair<uint64_t, uint64_t>& words) const {
+            return std::hash<uint64_t>()(words.first * 0x9e3779b97f4a7c15 ^ words.second);
+        }
+    };
+
+    static ConsTable& Instance();
+
+    // `make` allocates the object when the table has none equal to `key`.
+    template <class Map, class Key, class Make>
+    Value Intern(Map* map, const Key& key, Make make);
+
+    static thread_local bool enabled;
+
+    std::mutex mutex_;
+    std::unordered_map<std::pair<uint64_t, uint64_t>, Object*, WordPairHash> cells_;
+    std::unordered_map<uint64_t, Object*> quotes_;
+    std::unordered_map<BigInteger, Object*, BigIntegerHash> numbers_;
+};
+
+// Turns hash-consing on or off for the objects the current thread makes
+// until the scope ends.
+class HashConsScope {
+public:
+    explicit HashConsScope(bool enabled = true);
+    ~HashConsScope();
+
+    HashConsScope(const HashConsScope&) = delete;
+    HashConsScope& operator=(const HashConsScope&) = delete;
+
+private:
+    bool previous_;
+};
@@ -0,0 +1,64 @@
+#include "binary_ast.h"
+#include "input_source.h"
+#include "printer.h"
+
+#include <cerrno>
+#include <fstream>
+#include <iostream>
+#include <system_error>
+
+// Converts a program between its text form and the binary AST format:
+//
+//   scheme_basic_convert INPUT OUTPUT
+//
+// A binary input, recognized by its magic, is written back as text with one
+// form per line; any other input is parsed and written as binary.
+
+namespace {
+
+void ToBinary(std::string_view text, std::ostream* output) {
+    StringSource source(text);
+    Tokenizer tokenizer(&source);
+    BinaryAstWriter writer;
+    while (!tokenizer.IsEnd()) {
+        writer.Add(Read(&tokenizer));
+    }
+    *output << writer.Finish();
+}
+
+void ToText(std::string_view binary, std::ostream* output) {
+    BinaryAstReader reader(binary);
+    while (!reader.IsEnd()) {
+        Print(reader.Read(), output);
+        *output << '\n';
+    }
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    if (argc != 3) {
+        std::cerr << "usage: " << argv[0] << " INPUT OUTPUT\n";
+        return 2;
+    }
+    try {
+        MappedFileSource input(argv[1]);
+        std::string_view data = input.NextChunk();
+        std::ofstream output(argv[2], std::ios::binary);
+        if (!output) {
+            throw std::system_error(errno, std::generic_category(), std::string("open ") + argv[2]);
+        }
+        if (IsBinaryAst(data)) {
+            ToText(data, &output);
+        } else {
+            ToBinary(data, &output);
+        }
+        if (!output.flush()) {
+            throw std::system_error(errno, std::generic_category(), std::string("write ") + argv[2]);
+        }
+    } catch (const std::exception& error) {
+        std::cerr << argv[0] << ": " << error.what() << '\n';
+        return 1;
+    }
+    return 0;
+}
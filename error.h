@@ -13,3 +13,10 @@ struct RuntimeError : public std::runtime_error {
 struct NameError : public std::runtime_error {
     using std::runtime_error::runtime_error;
 };
+
+// A RunLimits budget ran out or the run was cancelled, see budget.h. Also a
+// RuntimeError, so callers that only tell syntax from runtime errors apart
+// still see one.
+struct LimitError : public RuntimeError {
+    using RuntimeError::RuntimeError;
+};
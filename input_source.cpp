@@ -0,0 +1,86 @@
+#include "input_source.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <system_error>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+StringSource::StringSource(std::string_view input) : input_(input) {
+}
+
+std::string_view StringSource::NextChunk() {
+    return std::exchange(input_, {});
+}
+
+StreamSource::StreamSource(std::istream* in, size_t block_size) : in_(in), buffer_(block_size, 0) {
+}
+
+std::string_view StreamSource::NextChunk() {
+    std::streambuf* buffer = in_->rdbuf();
+    if (buffer->sgetc() == std::char_traits<char>::eof()) {
+        return {};
+    }
+    std::streamsize available = std::max<std::streamsize>(buffer->in_avail(), 1);
+    std::streamsize size =
+        buffer->sgetn(buffer_.data(), std::min<std::streamsize>(available, buffer_.size()));
+    return {buffer_.data(), static_cast<size_t>(size)};
+}
+
+FdSource::FdSource(int fd, size_t block_size) : fd_(fd), buffer_(block_size, 0) {
+}
+
+std::string_view FdSource::NextChunk() {
+    while (true) {
+        ssize_t size = read(fd_, buffer_.data(), buffer_.size());
+        if (size >= 0) {
+            return {buffer_.data(), static_cast<size_t>(size)};
+        }
+        if (errno != EINTR) {
+            throw std::system_error(errno, std::generic_category(), "read");
+        }
+    }
+}
+
+MappedFileSource::MappedFileSource(const std::string& path) {
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        throw std::system_error(errno, std::generic_category(), "open " + path);
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0) {
+        int error = errno;
+        close(fd);
+        throw std::system_error(error, std::generic_category(), "fstat " + path);
+    }
+    size_ = info.st_size;
+    if (size_ > 0) {
+        void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (data == MAP_FAILED) {
+            int error = errno;
+            close(fd);
+            throw std::system_error(error, std::generic_category(), "mmap " + path);
+        }
+        madvise(data, size_, MADV_SEQUENTIAL);
+        data_ = static_cast<const char*>(data);
+    }
+    close(fd);
+}
+
+MappedFileSource::~MappedFileSource() {
+    if (data_) {
+        munmap(const_cast<char*>(data_), size_);
+    }
+}
+
+std::string_view MappedFileSource::NextChunk() {
+    if (consumed_) {
+        return {};
+    }
+    consumed_ = true;
+    return {data_, size_};
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <cstddef>
+#include <istream>
+#include <string>
+#include <string_view>
+
+// Buffered input for the Tokenizer. A source hands out its data as contiguous
+// chunks which the tokenizer scans in place, one chunk at a time.
+class InputSource {
+public:
+    virtual ~InputSource() = default;
+
+    // Returns the next chunk, or an empty view at the end of the input.
+    virtual std::string_view NextChunk() = 0;
+
+    // True if chunks stay valid for the lifetime of the source, so tokens may
+    // point into them; otherwise a chunk dies with the next call to NextChunk.
+    virtual bool IsPersistent() const {
+        return false;
+    }
+};
+
+// Input already in memory, handed out as a single chunk without copying.
+// The viewed characters must outlive the source.
+class StringSource : public InputSource {
+public:
+    explicit StringSource(std::string_view input);
+
+    std::string_view NextChunk() override;
+    bool IsPersistent() const override {
+        return true;
+    }
+
+private:
+    std::string_view input_;
+};
+
+// Reads whatever the stream has buffered, waiting only for the first
+// character, so interactive input is tokenized as soon as it arrives.
+class StreamSource : public InputSource {
+public:
+    static constexpr size_t kDefaultBlockSize = 64 * 1024;
+
+    explicit StreamSource(std::istream* in, size_t block_size = kDefaultBlockSize);
+
+    std::string_view NextChunk() override;
+
+private:
+    std::istream* in_;
+    std::string buffer_;
+};
+
+// Reads a file descriptor in large blocks. The descriptor is not closed.
+class FdSource : public InputSource {
+public:
+    static constexpr size_t kDefaultBlockSize = 1024 * 1024;
+
+    explicit FdSource(int fd, size_t block_size = kDefaultBlockSize);
+
+    std::string_view NextChunk() override;
+
+private:
+    int fd_;
+    std::string buffer_;
+};
+
+// Maps a whole file into memory and hands it out as a single chunk.
+// Throws std::system_error if the file cannot be opened or mapped.
+class MappedFileSource : public InputSource {
+public:
+    explicit MappedFileSource(const std::string& path);
+    ~MappedFileSource();
+
+    MappedFileSource(const MappedFileSource&) = delete;
+    MappedFileSource& operator=(const MappedFileSource&) = delete;
+
+    std::string_view NextChunk() override;
+    bool IsPersistent() const override {
+        return true;
+    }
+
+private:
+    const char* data_ = nullptr;
+    size_t size_ = 0;
+    bool consumed_ = false;
+};
@@ -13,8 +13,10 @@ public:
         return '0' <= a && a <= '9';
     }
 
+    // '?' starts the slots of a prepared expression, see PreparedExpression.
     static bool IsStartSymbol(const char& a) {
-        return IsLetter(a) || a == '<' || a == '=' || a == '>' || a == '*' || a == '/' || a == '#';
+        return IsLetter(a) || a == '<' || a == '=' || a == '>' || a == '*' || a == '/' || a == '#' ||
+               a == '?';
     }
 
     static bool IsInnerSymbol(const char& a) {
@@ -0,0 +1,136 @@
+#include "metrics.h"
+#include <cstdio>
+
+thread_local Metrics* Metrics::current = nullptr;
+
+void LatencyHistogram::Record(uint64_t nanoseconds) {
+    size_t bucket = 0;
+    while (bucket < kBounds && nanoseconds > GetBoundNs(bucket)) {
+        ++bucket;
+    }
+    buckets_[bucket] += 1;
+    count_ += 1;
+    sum_ns_ += nanoseconds;
+}
+
+void LatencyHistogram::Merge(const LatencyHistogram& other) {
+    for (size_t i = 0; i < buckets_.size(); ++i) {
+        buckets_[i] += other.buckets_[i];
+    }
+    count_ += other.count_;
+    sum_ns_ += other.sum_ns_;
+}
+
+const char* GetStageName(Stage stage) {
+    switch (stage) {
+        case Stage::kRead:
+            return "read";
+        case Stage::kEvaluate:
+            return "evaluate";
+        case Stage::kPrint:
+            return "print";
+    }
+    return "unknown";
+}
+
+Metrics::Metrics() : builtins_(GetBuiltinCount()) {
+}
+
+void Metrics::Merge(const Metrics& other) {
+    for (size_t i = 0; i < builtins_.size(); ++i) {
+        builtins_[i].calls += other.builtins_[i].calls;
+        builtins_[i].nanoseconds += other.builtins_[i].nanoseconds;
+    }
+    for (size_t i = 0; i < stages_.size(); ++i) {
+        stages_[i].Merge(other.stages_[i]);
+    }
+    for (size_t i = 0; i < errors_.size(); ++i) {
+        errors_[i] += other.errors_[i];
+    }
+}
+
+MetricsScope::MetricsScope(Metrics* metrics) : previous_(Metrics::current) {
+    Metrics::current = metrics;
+}
+
+MetricsScope::~MetricsScope() {
+    Metrics::current = previous_;
+}
+
+namespace {
+
+// Appends one sample line; builtin and stage names need no escaping.
+void AppendSample(std::string* output, const char* name, const char* labels, double value) {
+    char buffer[256];
+    int size = std::snprintf(buffer, sizeof(buffer), "%s{%s} %.9g\n", name, labels, value);
+    output->append(buffer, size);
+}
+
+void AppendHeader(std::string* output, const char* name, const char* type, const char* help) {
+    *output += "# HELP ";
+    *output += name;
+    *output += ' ';
+    *output += help;
+    *output += "\n# TYPE ";
+    *output += name;
+    *output += ' ';
+    *output += type;
+    *output += '\n';
+}
+
+std::string Label(const char* key, const char* value) {
+    return std::string(key) + "=\"" + value + "\"";
+}
+
+}  // namespace
+
+std::string FormatPrometheus(const Metrics& metrics) {
+    std::string output;
+    AppendHeader(&output, "scheme_builtin_calls_total", "counter",
+                 "Calls of each builtin.");
+    for (uint32_t id = 0; id < GetBuiltinCount(); ++id) {
+        AppendSample(&output, "scheme_builtin_calls_total",
+                     Label("builtin", GetBuiltin(id).name).c_str(),
+                     metrics.GetBuiltinMetrics(id).calls);
+    }
+    AppendHeader(&output, "scheme_builtin_seconds_total", "counter",
+                 "Time spent in each builtin kernel.");
+    for (uint32_t id = 0; id < GetBuiltinCount(); ++id) {
+        AppendSample(&output, "scheme_builtin_seconds_total",
+                     Label("builtin", GetBuiltin(id).name).c_str(),
+                     metrics.GetBuiltinMetrics(id).nanoseconds * 1e-9);
+    }
+
+    AppendHeader(&output, "scheme_stage_seconds", "histogram", "Latency of each stage of Run.");
+    for (Stage stage : {Stage::kRead, Stage::kEvaluate, Stage::kPrint}) {
+        const LatencyHistogram& histogram = metrics.GetStageLatency(stage);
+        std::string label = Label("stage", GetStageName(stage));
+        // Prometheus buckets are cumulative.
+        uint64_t cumulative = 0;
+        for (size_t i = 0; i <= LatencyHistogram::kBounds; ++i) {
+            cumulative += histogram.GetBucket(i);
+            char bound[32] = "+Inf";
+            if (i < LatencyHistogram::kBounds) {
+                std::snprintf(bound, sizeof(bound), "%.9g", LatencyHistogram::GetBoundNs(i) * 1e-9);
+            }
+            AppendSample(&output, "scheme_stage_seconds_bucket",
+                         (label + "," + Label("le", bound)).c_str(), cumulative);
+        }
+        AppendSample(&output, "scheme_stage_seconds_sum", label.c_str(),
+                     histogram.GetSumNs() * 1e-9);
+        AppendSample(&output, "scheme_stage_seconds_count", label.c_str(), histogram.GetCount());
+    }
+
+    AppendHeader(&output, "scheme_errors_total", "counter", "Errors reported, by type.");
+    const std::pair<BatchResult::Status, const char*> kErrors[] = {
+        {BatchResult::Status::kSyntaxError, "syntax"},
+        {BatchResult::Status::kRuntimeError, "runtime"},
+        {BatchResult::Status::kNameError, "name"},
+        {BatchResult::Status::kLimitError, "limit"},
+    };
+    for (const auto& [status, name] : kErrors) {
+        AppendSample(&output, "scheme_errors_total", Label("type", name).c_str(),
+                     metrics.GetErrorCount(status));
+    }
+    return output;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "builtins.h"
+#include "result_cache.h"
+
+// Latencies in fixed buckets whose upper bounds grow by a factor of four,
+// from one microsecond to about four seconds, plus an unbounded last one.
+class LatencyHistogram {
+public:
+    static constexpr size_t kBounds = 12;
+    static constexpr uint64_t kFirstBoundNs = 1000;
+
+    // Upper bound of bucket i < kBounds.
+    static constexpr uint64_t GetBoundNs(size_t i) {
+        return kFirstBoundNs << (2 * i);
+    }
+
+    void Record(uint64_t nanoseconds);
+    void Merge(const LatencyHistogram& other);
+
+    // Samples in bucket i; bucket kBounds holds those above every bound.
+    uint64_t GetBucket(size_t i) const {
+        return buckets_[i];
+    }
+    uint64_t GetCount() const {
+        return count_;
+    }
+    uint64_t GetSumNs() const {
+        return sum_ns_;
+    }
+
+private:
+    std::array<uint64_t, kBounds + 1> buckets_{};
+    uint64_t count_ = 0;
+    uint64_t sum_ns_ = 0;
+};
+
+// Steps of Run. Read covers tokenizing too: the parser pulls tokens on
+// demand, so the two are not timed apart.
+enum class Stage { kRead, kEvaluate, kPrint };
+
+inline constexpr size_t kStageCount = 3;
+
+const char* GetStageName(Stage stage);
+
+struct BuiltinMetrics {
+    uint64_t calls = 0;
+    uint64_t nanoseconds = 0;
+};
+
+// Counters of an Interpreter with InterpreterOptions::metrics: calls of each
+// builtin and the time spent in their kernels, latencies of every stage and
+// the errors reported, by type. Builtins that control the evaluation of their
+// operands (and, or, comparisons, list) run no kernel: their calls are
+// counted as they start, and no time is recorded for them.
+class Metrics {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    Metrics();
+
+    // Runs the kernel of builtin `id` and accounts for it.
+    AST CallBuiltin(uint32_t id, std::span<const AST> args) {
+        auto start = Clock::now();
+        AST result = GetBuiltin(id).kernel(args);
+        builtins_[id].calls += 1;
+        builtins_[id].nanoseconds += GetElapsedNs(start);
+        return result;
+    }
+
+    // A call of builtin `id`, one without a kernel.
+    void CountCall(uint32_t id) {
+        builtins_[id].calls += 1;
+    }
+
+    void RecordStage(Stage stage, Clock::time_point start) {
+        stages_[static_cast<size_t>(stage)].Record(GetElapsedNs(start));
+    }
+
+    void CountError(BatchResult::Status status) {
+        errors_[static_cast<size_t>(status)] += 1;
+    }
+
+    void Merge(const Metrics& other);
+
+    const BuiltinMetrics& GetBuiltinMetrics(uint32_t id) const {
+        return builtins_[id];
+    }
+    const LatencyHistogram& GetStageLatency(Stage stage) const {
+        return stages_[static_cast<size_t>(stage)];
+    }
+    uint64_t GetErrorCount(BatchResult::Status status) const {
+        return errors_[static_cast<size_t>(status)];
+    }
+
+    // The metrics of the current thread's evaluation, if it collects any.
+    static Metrics* Current() {
+        return current;
+    }
+
+private:
+    friend class MetricsScope;
+
+    static uint64_t GetElapsedNs(Clock::time_point start) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - start).count();
+    }
+
+    static thread_local Metrics* current;
+
+    std::vector<BuiltinMetrics> builtins_;
+    std::array<LatencyHistogram, kStageCount> stages_;
+    // Indexed by status, kOk stays zero.
+    std::array<uint64_t, 5> errors_{};
+};
+
+// Routes the builtin calls of the current thread to `metrics` until the scope
+// ends, nullptr turns collection off.
+class MetricsScope {
+public:
+    explicit MetricsScope(Metrics* metrics);
+    ~MetricsScope();
+
+    MetricsScope(const MetricsScope&) = delete;
+    MetricsScope& operator=(const MetricsScope&) = delete;
+
+private:
+    Metrics* previous_;
+};
+
+// Times one stage into `metrics` unless it is nullptr.
+class StageTimer {
+public:
+    StageTimer(Metrics* metrics, Stage stage) : metrics_(metrics), stage_(stage) {
+        if (metrics_) {
+            start_ = Metrics::Clock::now();
+        }
+    }
+    ~StageTimer() {
+        if (metrics_) {
+            metrics_->RecordStage(stage_, start_);
+        }
+    }
+
+    StageTimer(const StageTimer&) = delete;
+    StageTimer& operator=(const StageTimer&) = delete;
+
+private:
+    Metrics* metrics_;
+    Stage stage_;
+    Metrics::Clock::time_point start_;
+};
+
+// A snapshot in the Prometheus text exposition format: the counters
+// scheme_builtin_calls_total, scheme_builtin_seconds_total and
+// scheme_errors_total, and the histogram scheme_stage_seconds.
+std::string FormatPrometheus(const Metrics& metrics);
@@ -1,57 +1,265 @@
 #include "object.h"
+#include "arena.h"
+#include "budget.h"
+#include "cons_table.h"
+#include <algorithm>
+#include <vector>
 
-Number::Number(int64_t value) : value_(value) {
+Object::Object(ObjectType type) : type_(type) {
 }
 
-int64_t Number::GetValue() const {
-    return value_;
+// Bytes of the allocation of an object that is not part of a run.
+static size_t GetAllocationSize(const Object* object) {
+    switch (object->GetType()) {
+        case ObjectType::kNumber:
+            return static_cast<const Number*>(object)->GetAllocationSize();
+        case ObjectType::kQuote:
+            return sizeof(Quote);
+        case ObjectType::kCell:
+            return sizeof(Cell);
+        default:
+            return 0;
+    }
 }
 
-Symbol::Symbol(std::string symbol) : symbol_(symbol) {
+// Deleting a cell releases its children, which may drop to zero in turn. Those
+// are queued and deleted by the outermost call, so freeing a long or deeply
+// nested list takes a loop instead of one native frame per element.
+void Value::Destroy(Object* object) {
+    static thread_local std::vector<Object*> pending;
+    static thread_local bool draining = false;
+    if (draining) {
+        pending.push_back(object);
+        return;
+    }
+    draining = true;
+    auto destroy = [](Object* dead) {
+        if (dead->IsInterned()) {
+            ConsTable::Forget(dead);
+        }
+        if (dead->GetType() != ObjectType::kCell || !static_cast<Cell*>(dead)->run_) {
+            if (Budget* budget = Budget::Current()) [[unlikely]] {
+                budget->Release(GetAllocationSize(dead));
+            }
+            delete dead;
+            return;
+        }
+        auto cell = static_cast<Cell*>(dead);
+        // Every other cell of the run is already gone once its last one dies.
+        bool last = cell->run_ == 1;
+        cell->~Cell();
+        if (last) {
+            size_t length = *reinterpret_cast<const size_t*>(cell + 1);
+            ReleaseAllocation(length * sizeof(Cell) + sizeof(size_t));
+            ::operator delete(cell + 1 - length);
+        }
+    };
+    destroy(object);
+    while (!pending.empty()) {
+        Object* next = pending.back();
+        pending.pop_back();
+        destroy(next);
+    }
+    draining = false;
 }
 
-const std::string& Symbol::GetName() const {
-    return symbol_;
+Number::Number(bool negative, std::span<const uint32_t> limbs)
+    : Object(kType), negative_(negative), size_(limbs.size()) {
+    std::ranges::copy(limbs, reinterpret_cast<uint32_t*>(this + 1));
+}
+
+size_t Number::GetSize(size_t limbs) {
+    return sizeof(Number) + limbs * sizeof(uint32_t);
+}
+
+void* Number::operator new(size_t, size_t limbs) {
+    return ::operator new(GetSize(limbs));
+}
+
+void* Number::operator new(size_t, void* place) {
+    return place;
 }
 
-Boolean::Boolean(bool value) : value_(value) {
+void Number::operator delete(void* object) {
+    ::operator delete(object);
 }
 
-bool Boolean::GetValue() const {
-    return value_;
+BigInteger Number::GetValue() const {
+    return BigInteger::FromLimbs(negative_, {reinterpret_cast<const uint32_t*>(this + 1), size_});
 }
 
-Quote::Quote() : cmd_(nullptr) {
+Symbol::Symbol(std::string symbol, uint32_t id) : Object(kType), symbol_(symbol), id_(id) {
 }
 
-Quote::Quote(std::shared_ptr<Object> cmd) : cmd_(cmd) {
+const std::string& Symbol::GetName() const {
+    return symbol_;
 }
 
-std::shared_ptr<Object> Quote::GetCommand() const {
+uint32_t Symbol::GetId() const {
+    return id_;
+}
+
+Quote::Quote() : Object(kType), cmd_(nullptr) {
+}
+
+Quote::Quote(Value cmd) : Object(kType), cmd_(std::move(cmd)) {
+}
+
+const Value& Quote::GetCommand() const {
     return cmd_;
 }
 
-Cell::Cell() {
+Cell::Cell() : Object(kType) {
     first_ = nullptr;
     second_ = nullptr;
 }
 
-Cell::Cell(const std::shared_ptr<Object>& lhs, const std::shared_ptr<Object>& rhs)
-    : first_(lhs), second_(rhs) {
+Cell::Cell(Value lhs, Value rhs) : Object(kType), first_(std::move(lhs)), second_(std::move(rhs)) {
 }
 
-void Cell::SetFirst(std::shared_ptr<Object>&& other) {
-    first_ = other;
+const Value& Cell::GetFirst() const {
+    return first_;
 }
 
-void Cell::SetSecond(std::shared_ptr<Object>&& other) {
-    second_ = other;
+const Value& Cell::GetSecond() const {
+    return second_;
 }
 
-std::shared_ptr<Object> Cell::GetFirst() const {
-    return first_;
+template <class T, class... Args>
+static Value MakeObject(Args&&... args) {
+    if (Arena* arena = Arena::Current()) {
+        return Value::Unmanaged(new (arena->Allocate(sizeof(T))) T(std::forward<Args>(args)...));
+    }
+    return Value(new T(std::forward<Args>(args)...));
 }
 
-std::shared_ptr<Object> Cell::GetSecond() const {
-    return second_;
+static Value MakeBoxedNumber(bool negative, std::span<const uint32_t> limbs) {
+    ChargeAllocation(Number::GetSize(limbs.size()));
+    if (Arena* arena = Arena::Current()) {
+        void* memory = arena->Allocate(Number::GetSize(limbs.size()));
+        return Value::Unmanaged(new (memory) Number(negative, limbs));
+    }
+    if (ConsTable::IsEnabled()) {
+        return ConsTable::MakeBoxedNumber(BigInteger::FromLimbs(negative, limbs));
+    }
+    return Value(new (limbs.size()) Number(negative, limbs));
+}
+
+// Outside the fixnum range the magnitude always needs both limbs.
+Value MakeBoxedNumber(int64_t value) {
+    uint64_t magnitude = value < 0 ? 0 - static_cast<uint64_t>(value) : value;
+    uint32_t limbs[] = {static_cast<uint32_t>(magnitude), static_cast<uint32_t>(magnitude >> 32)};
+    return MakeBoxedNumber(value < 0, limbs);
+}
+
+Value MakeNumber(const BigInteger& value) {
+    int64_t small;
+    if (value.ToInt64(&small) && Value::kMinFixnum <= small && small <= Value::kMaxFixnum) {
+        return Value::Fixnum(small);
+    }
+    return MakeBoxedNumber(value.IsNegative(), value.GetLimbs());
+}
+
+Value MakeQuote(Value cmd) {
+    ChargeAllocation(sizeof(Quote));
+    if (!Arena::Current() && ConsTable::IsEnabled()) {
+        return ConsTable::MakeQuote(std::move(cmd));
+    }
+    return MakeObject<Quote>(std::move(cmd));
+}
+
+Value MakeCell(Value first, Value second) {
+    ChargeAllocation(sizeof(Cell));
+    if (!Arena::Current() && ConsTable::IsEnabled()) {
+        return ConsTable::MakeCell(std::move(first), std::move(second));
+    }
+    return MakeObject<Cell>(std::move(first), std::move(second));
+}
+
+// A run is followed by its length, so that its last cell finds where the
+// allocation starts.
+Value MakeList(std::span<Value> items, Value tail) {
+    Arena* arena = Arena::Current();
+    size_t max_run = Cell::kMaxRunLength;
+    if (arena) {
+        // The length footer fits into the spare room of one more cell.
+        max_run = std::min(max_run, arena->GetBlockSize() / sizeof(Cell) - 1);
+    } else if (ConsTable::IsEnabled()) {
+        max_run = 1;
+    }
+
+    for (size_t end = items.size(); end > 0;) {
+        size_t length = std::min(end, max_run);
+        size_t start = end - length;
+        end = start;
+        if (length < 2) {
+            tail = MakeCell(std::move(items[start]), std::move(tail));
+            continue;
+        }
+        size_t bytes = length * sizeof(Cell) + sizeof(size_t);
+        ChargeAllocation(bytes, length);
+        auto cells = static_cast<Cell*>(arena ? arena->Allocate(bytes) : ::operator new(bytes));
+        new (cells + length) size_t(length);
+        for (size_t i = length; i-- > 0;) {
+            Cell* cell = new (cells + i) Cell(std::move(items[start + i]), std::move(tail));
+            cell->run_ = length - i;
+            tail = arena ? Value::Unmanaged(cell) : Value(cell);
+        }
+    }
+    return tail;
+}
+
+const Value& SkipCells(const Value& list, size_t* steps) {
+    const Value* operand = &list;
+    while (*steps > 0 && Is<Cell>(*operand)) {
+        const Cell* cell = As<Cell>(*operand);
+        size_t jump = std::min(*steps - 1, cell->GetRunLength());
+        *steps -= jump + 1;
+        operand = &cell->GetRunCell(jump)->GetSecond();
+    }
+    return *operand;
+}
+
+bool IsProperList(const Value& value) {
+    size_t steps = SIZE_MAX;
+    return SkipCells(value, &steps) == nullptr;
+}
+
+bool IsEqual(const Value& lhs, const Value& rhs) {
+    if (lhs == rhs) {
+        return true;
+    }
+    std::vector<std::pair<const Value*, const Value*>> stack = {{&lhs, &rhs}};
+    while (!stack.empty()) {
+        auto [a, b] = stack.back();
+        stack.pop_back();
+        if (*a == *b) {
+            continue;
+        }
+        if ((ConsTable::IsCanonical(*a) && ConsTable::IsCanonical(*b)) || *a == nullptr ||
+            *b == nullptr || a->GetType() != b->GetType()) {
+            return false;
+        }
+        switch (a->GetType()) {
+            case ObjectType::kNumber:
+                // A fixnum never equals a boxed number, nor another fixnum here.
+                if (a->IsFixnum() || b->IsFixnum() ||
+                    As<Number>(*a)->GetValue() != As<Number>(*b)->GetValue()) {
+                    return false;
+                }
+                break;
+            case ObjectType::kBoolean:
+            case ObjectType::kSymbol:
+                // Immediates and interned symbols are equal only as the same word.
+                return false;
+            case ObjectType::kQuote:
+                stack.push_back({&As<Quote>(*a)->GetCommand(), &As<Quote>(*b)->GetCommand()});
+                break;
+            case ObjectType::kCell:
+                stack.push_back({&As<Cell>(*a)->GetSecond(), &As<Cell>(*b)->GetSecond()});
+                stack.push_back({&As<Cell>(*a)->GetFirst(), &As<Cell>(*b)->GetFirst()});
+                break;
+        }
+    }
+    return true;
 }
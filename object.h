@@ -1,89 +1,355 @@
 #pragma once
 
+#include <atomic>
 #include <memory>
+#include <span>
 
+#include "big_integer.h"
 #include "tokenizer.h"
 
-class Object : public std::enable_shared_from_this<Object> {
+// Every value carries its concrete type, so type checks are a single compare.
+enum class ObjectType : uint8_t { kNumber, kSymbol, kBoolean, kQuote, kCell };
+
+// Heap objects are reference counted intrusively by the Values pointing at them.
+class Object {
 public:
+    Object(ObjectType type);
     virtual ~Object() = default;
+
+    Object(const Object&) = delete;
+    Object& operator=(const Object&) = delete;
+
+    ObjectType GetType() const {
+        return type_;
+    }
+
+    // True for the canonical copies kept by ConsTable.
+    bool IsInterned() const {
+        return interned_;
+    }
+
+private:
+    friend class Value;
+    friend class ConsTable;
+
+    mutable std::atomic<uint32_t> references_ = 0;
+    const ObjectType type_;
+    bool interned_ = false;
+};
+
+// A single tagged word:
+//   ...xx1  fixnum, the value is stored in the upper 63 bits;
+//   ...010  boolean, the value is stored in bit 3;
+//   ...000  reference counted pointer to a heap Object, the null pointer is the empty list;
+//   ...100  unmanaged pointer to an Object whose lifetime is owned elsewhere
+//           (interned symbols, objects allocated from an Arena), never counted.
+// Only symbols, quotes, cells and numbers outside the fixnum range live on the heap.
+class Value {
+public:
+    static constexpr int64_t kMinFixnum = -(int64_t{1} << 62);
+    static constexpr int64_t kMaxFixnum = (int64_t{1} << 62) - 1;
+
+    Value() = default;
+    Value(std::nullptr_t) {
+    }
+    explicit Value(Object* object) : word_(reinterpret_cast<uint64_t>(object)) {
+        Retain();
+    }
+
+    Value(const Value& other) : word_(other.word_) {
+        Retain();
+    }
+    Value(Value&& other) noexcept : word_(other.word_) {
+        other.word_ = 0;
+    }
+    Value& operator=(const Value& other) {
+        Value copy(other);
+        std::swap(word_, copy.word_);
+        return *this;
+    }
+    Value& operator=(Value&& other) noexcept {
+        std::swap(word_, other.word_);
+        return *this;
+    }
+    ~Value() {
+        Release();
+    }
+
+    static Value Fixnum(int64_t value) {
+        return Value((static_cast<uint64_t>(value) << 1) | kFixnumTag);
+    }
+    static Value Bool(bool value) {
+        return Value((static_cast<uint64_t>(value) << 3) | kBooleanTag);
+    }
+    static Value Unmanaged(Object* object) {
+        return Value(reinterpret_cast<uint64_t>(object) | kUnmanagedTag);
+    }
+
+    bool IsFixnum() const {
+        return word_ & kFixnumTag;
+    }
+    bool IsBoolean() const {
+        return (word_ & kTagMask) == kBooleanTag;
+    }
+    bool IsObject() const {
+        return word_ != 0 && (word_ & kPointerMask) == 0;
+    }
+    // A heap object whose lifetime this Value shares, as opposed to an
+    // immediate or an unmanaged pointer.
+    bool IsCounted() const {
+        return word_ != 0 && (word_ & kTagMask) == 0;
+    }
+
+    // Must not be called on the empty list.
+    ObjectType GetType() const {
+        if (IsFixnum()) {
+            return ObjectType::kNumber;
+        }
+        if (IsBoolean()) {
+            return ObjectType::kBoolean;
+        }
+        return GetObject()->GetType();
+    }
+
+    Object* GetObject() const {
+        return reinterpret_cast<Object*>(word_ & ~kTagMask);
+    }
+    // Only numbers that fit into int64_t are read this way, any number can be
+    // read with GetBigInteger.
+    int64_t GetNumber() const;
+    BigInteger GetBigInteger() const;
+    bool GetBoolean() const {
+        return word_ >> 3;
+    }
+
+    uint64_t GetWord() const {
+        return word_;
+    }
+
+    // A counted Value for `object`, or the empty list if its count already
+    // dropped to zero and it is being destroyed. Lets a weak table hand out
+    // its entries without resurrecting a dying one.
+    static Value TryRetain(Object* object) {
+        uint32_t references = object->references_.load(std::memory_order_relaxed);
+        while (references != 0) {
+            if (object->references_.compare_exchange_weak(references, references + 1,
+                                                          std::memory_order_relaxed)) {
+                return Value(reinterpret_cast<uint64_t>(object));
+            }
+        }
+        return nullptr;
+    }
+
+    bool operator==(const Value& other) const {
+        return word_ == other.word_;
+    }
+    bool operator==(std::nullptr_t) const {
+        return word_ == 0;
+    }
+    explicit operator bool() const {
+        return word_ != 0;
+    }
+
+private:
+    static constexpr uint64_t kFixnumTag = 1;
+    static constexpr uint64_t kBooleanTag = 2;
+    static constexpr uint64_t kUnmanagedTag = 4;
+    static constexpr uint64_t kPointerMask = 3;
+    static constexpr uint64_t kTagMask = 7;
+
+    explicit Value(uint64_t word) : word_(word) {
+    }
+
+    void Retain() const {
+        if (IsCounted()) {
+            GetObject()->references_.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+    void Release() {
+        if (IsCounted() && GetObject()->references_.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            Destroy(GetObject());
+        }
+    }
+    static void Destroy(Object* object);
+
+    uint64_t word_ = 0;
 };
 
 class Number : public Object {
 public:
-    Number(int64_t value);
+    static constexpr ObjectType kType = ObjectType::kNumber;
+
+    // Boxed form of the numbers that do not fit into a fixnum; a number that
+    // fits is never boxed, see MakeNumber. The limbs of the BigInteger follow
+    // the object in the same allocation, `new (limbs.size())` reserves them.
+    Number(bool negative, std::span<const uint32_t> limbs);
     ~Number() = default;
 
-    int64_t GetValue() const;
+    static size_t GetSize(size_t limbs);
+    static void* operator new(size_t size, size_t limbs);
+    static void* operator new(size_t size, void* place);
+    static void operator delete(void* object);
+
+    BigInteger GetValue() const;
+
+    // Bytes of this number's allocation, limbs included.
+    size_t GetAllocationSize() const {
+        return GetSize(size_);
+    }
 
 private:
-    int64_t value_;
+    bool negative_;
+    uint32_t size_;
 };
 
 class Symbol : public Object {
 public:
-    Symbol(std::string symbol);
+    static constexpr ObjectType kType = ObjectType::kSymbol;
+
+    // Symbols are created by SymbolTable::Intern only.
+    Symbol(std::string symbol, uint32_t id);
     ~Symbol() = default;
 
     const std::string& GetName() const;
+    uint32_t GetId() const;
 
 private:
     std::string symbol_;
+    uint32_t id_;
 };
 
-class Boolean : public Object {
+// Booleans are always immediate, the class only names their type for Is<Boolean>.
+class Boolean {
 public:
-    Boolean(bool value);
-    ~Boolean() = default;
-
-    bool GetValue() const;
+    static constexpr ObjectType kType = ObjectType::kBoolean;
 
-private:
-    bool value_;
+    Boolean() = delete;
 };
 
 class Quote : public Object {
 public:
+    static constexpr ObjectType kType = ObjectType::kQuote;
+
     Quote();
-    Quote(std::shared_ptr<Object> cmd);
+    Quote(Value cmd);
     ~Quote() = default;
 
-    std::shared_ptr<Object> GetCommand() const;
+    const Value& GetCommand() const;
 
 private:
-    std::shared_ptr<Object> cmd_;
+    Value cmd_;
 };
 
+// Cells made together by MakeList lie next to each other in one allocation,
+// each one's second pointing at its neighbour (CDR coding). A cell of such a
+// run knows how many cells follow it there, so walking a list can jump over
+// the run instead of loading every link. Every cell is still an ordinary
+// counted Cell: a tail taken from the middle of a run keeps the rest of the
+// run alive, and the memory is freed with the last cell, which always dies last.
 class Cell : public Object {
 public:
+    static constexpr ObjectType kType = ObjectType::kCell;
+    static constexpr size_t kMaxRunLength = UINT16_MAX;
+
     Cell();
-    Cell(const std::shared_ptr<Object>& lhs, const std::shared_ptr<Object>& rhs);
+    Cell(Value lhs, Value rhs);
     ~Cell() = default;
 
-    void SetFirst(std::shared_ptr<Object>&& other);
-    void SetSecond(std::shared_ptr<Object>&& other);
+    const Value& GetFirst() const;
+    const Value& GetSecond() const;
 
-    std::shared_ptr<Object> GetFirst() const;
-    std::shared_ptr<Object> GetSecond() const;
+    // Cells directly following this one in its run, zero outside of a run.
+    size_t GetRunLength() const {
+        return run_ ? run_ - 1 : 0;
+    }
+    // The cell `offset` links further, for offset <= GetRunLength().
+    const Cell* GetRunCell(size_t offset) const {
+        return this + offset;
+    }
 
 private:
-    std::shared_ptr<Object> first_;
-    std::shared_ptr<Object> second_;
+    friend class Value;
+    friend Value MakeList(std::span<Value> items, Value tail);
 
-    friend std::shared_ptr<Object> ReadList(Tokenizer* tokenizer);
+    // One more than GetRunLength() for a cell of a run, zero for a plain cell.
+    // Fits the tail padding of Object, so it does not grow the cell.
+    uint16_t run_ = 0;
+    Value first_;
+    Value second_;
 };
 
+inline int64_t Value::GetNumber() const {
+    if (IsFixnum()) {
+        return static_cast<int64_t>(word_) >> 1;
+    }
+    int64_t value = 0;
+    static_cast<const Number*>(GetObject())->GetValue().ToInt64(&value);
+    return value;
+}
+
+inline BigInteger Value::GetBigInteger() const {
+    if (IsFixnum()) {
+        return BigInteger(GetNumber());
+    }
+    return static_cast<const Number*>(GetObject())->GetValue();
+}
+
+inline Value MakeBoolean(bool value) {
+    return Value::Bool(value);
+}
+
+Value MakeBoxedNumber(int64_t value);
+
+inline Value MakeNumber(int64_t value) {
+    if (Value::kMinFixnum <= value && value <= Value::kMaxFixnum) {
+        return Value::Fixnum(value);
+    }
+    return MakeBoxedNumber(value);
+}
+
+// Boxes the value only if it does not fit into a fixnum.
+Value MakeNumber(const BigInteger& value);
+
+// Heap objects are taken from the current thread's Arena when one is active,
+// otherwise from ConsTable while a HashConsScope is enabled.
+Value MakeQuote(Value cmd);
+Value MakeCell(Value first, Value second);
+
+// The proper or dotted list of `items` ending with `tail`, moving the items
+// out. Outside of a HashConsScope the cells are laid out in runs, see Cell.
+Value MakeList(std::span<Value> items, Value tail = nullptr);
+
+// The list `*steps` second links after `list`, jumping over runs. Stops early
+// at the first value that is not a cell, leaving in *steps the links not taken.
+const Value& SkipCells(const Value& list, size_t* steps);
+
+// True for the empty list and for cells chained up to the empty list.
+bool IsProperList(const Value& value);
+
+// Structural equality. Two canonical values, see ConsTable, are equal only if
+// they are the same word, so comparing them never walks their structure.
+bool IsEqual(const Value& lhs, const Value& rhs);
+
 ///////////////////////////////////////////////////////////////////////////////
 
 // Runtime type checking and conversion.
-// This can be helpful: https://en.cppreference.com/w/cpp/memory/shared_ptr/pointer_cast
+// Is<T> relies on the type tag. As<T> is only defined for heap types and must
+// only be called after a successful Is<T>; numbers and booleans are read with
+// Value::GetNumber and Value::GetBoolean, As<Number> only reaches boxed ones.
 
 template <class T>
-std::shared_ptr<T> As(const std::shared_ptr<Object>& obj) {
-    return reinterpret_cast<const std::shared_ptr<T>&>(obj);
+bool Is(const Value& value) {
+    if constexpr (std::is_same_v<T, Number>) {
+        return value.IsFixnum() || (value.IsObject() && value.GetObject()->GetType() == T::kType);
+    } else if constexpr (std::is_same_v<T, Boolean>) {
+        return value.IsBoolean();
+    } else {
+        return value.IsObject() && value.GetObject()->GetType() == T::kType;
+    }
 }
 
 template <class T>
-bool Is(const std::shared_ptr<Object>& obj) {
-    return dynamic_cast<T*>(obj.get()) != nullptr;
+T* As(const Value& value) {
+    static_assert(!std::is_same_v<T, Boolean>);
+    return static_cast<T*>(value.GetObject());
 }
@@ -0,0 +1,217 @@
+#include "optimizer.h"
+#include "builtins.h"
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace {
+
+// Numbers, booleans, symbols and quotes evaluate to themselves or their datum.
+bool IsLiteral(const AST& ast) {
+    return ast != nullptr && !Is<Cell>(ast);
+}
+
+AST GetLiteralValue(const AST& ast) {
+    return Is<Quote>(ast) ? As<Quote>(ast)->GetCommand() : ast;
+}
+
+bool IsFalse(const AST& value) {
+    return Is<Boolean>(value) && !value.GetBoolean();
+}
+
+struct WordPairHash {
+    size_t operator()(const std::pair<uint64_t, uint64_t>& words) const {
+        return std::hash<uint64_t>()(words.first * 0x9e3779b97f4a7c15 ^ words.second);
+    }
+};
+
+// Walks the expression without native recursion: a call is visited once to
+// schedule its subexpressions and once more, after all of them are rewritten,
+// to rebuild it from their results.
+class Optimizer {
+public:
+    Optimizer(const Folder& fold, size_t max_depth) : fold_(fold), max_depth_(max_depth) {
+    }
+
+    AST Run(const AST& root) {
+        tasks_.push_back({&root, 0, false});
+        while (!tasks_.empty()) {
+            Task task = tasks_.back();
+            tasks_.pop_back();
+            if (task.depth > max_depth_) {
+                return root;
+            }
+            if (task.rebuild) {
+                Rebuild(*task.ast);
+            } else {
+                Visit(*task.ast, task.depth);
+            }
+        }
+        return std::move(results_.back());
+    }
+
+private:
+    struct Task {
+        const AST* ast;
+        size_t depth;
+        bool rebuild;
+    };
+
+    // The builtin applied by a call to a builtin symbol on a proper list, if any.
+    static const Builtin* GetStaticBuiltin(const Cell* call) {
+        if (!Is<Symbol>(call->GetFirst())) {
+            return nullptr;
+        }
+        const AST* operand = &call->GetSecond();
+        while (Is<Cell>(*operand)) {
+            operand = &As<Cell>(*operand)->GetSecond();
+        }
+        return *operand == nullptr ? FindBuiltin(*As<Symbol>(call->GetFirst())) : nullptr;
+    }
+
+    void Visit(const AST& ast, size_t depth) {
+        if (!Is<Cell>(ast)) {
+            results_.push_back(Is<Quote>(ast) ? Share(ast) : ast);
+            return;
+        }
+        const Cell* call = As<Cell>(ast);
+        const AST& operation = call->GetFirst();
+        if (Is<Cell>(operation) || Is<Quote>(operation)) {
+            // The operator is only known once evaluated, its operands stay as written.
+            tasks_.push_back({&ast, depth, true});
+            tasks_.push_back({&operation, depth + 1, false});
+            return;
+        }
+        const Builtin* builtin = GetStaticBuiltin(call);
+        if (!builtin) {
+            results_.push_back(ast);
+            return;
+        }
+        tasks_.push_back({&ast, depth, true});
+        if (builtin->kind == BuiltinKind::kList) {
+            // The operands are data, not expressions.
+            return;
+        }
+        size_t first = tasks_.size();
+        for (const AST* operand = &call->GetSecond(); *operand;
+             operand = &As<Cell>(*operand)->GetSecond()) {
+            tasks_.push_back({&As<Cell>(*operand)->GetFirst(), depth + 1, false});
+        }
+        std::reverse(tasks_.begin() + first, tasks_.end());
+    }
+
+    void Rebuild(const AST& ast) {
+        const Cell* call = As<Cell>(ast);
+        if (!Is<Symbol>(call->GetFirst())) {
+            AST operation = std::move(results_.back());
+            results_.pop_back();
+            results_.push_back(Cons(std::move(operation), call->GetSecond()));
+            return;
+        }
+
+        const Builtin& builtin = *FindBuiltin(*As<Symbol>(call->GetFirst()));
+        if (builtin.kind == BuiltinKind::kList) {
+            results_.push_back(Fold(Cons(call->GetFirst(), call->GetSecond())));
+            return;
+        }
+
+        size_t count = 0;
+        for (const AST* operand = &call->GetSecond(); *operand;
+             operand = &As<Cell>(*operand)->GetSecond()) {
+            ++count;
+        }
+        std::vector<AST> operands(std::make_move_iterator(results_.end() - count),
+                                  std::make_move_iterator(results_.end()));
+        results_.erase(results_.end() - count, results_.end());
+
+        if (builtin.kind == BuiltinKind::kAnd || builtin.kind == BuiltinKind::kOr) {
+            results_.push_back(Prune(call->GetFirst(), builtin.kind == BuiltinKind::kAnd, operands));
+            return;
+        }
+        AST rebuilt = Cons(call->GetFirst(), MakeList(operands));
+        bool literal = std::all_of(operands.begin(), operands.end(), IsLiteral);
+        results_.push_back(literal ? Fold(rebuilt) : rebuilt);
+    }
+
+    // and stops at the first false value, or at the first true one. A literal
+    // that decides the result ends the list, the other literals are dropped
+    // unless they come last and so provide the result.
+    AST Prune(const AST& operation, bool is_and, const std::vector<AST>& operands) {
+        std::vector<AST> kept;
+        for (size_t i = 0; i < operands.size(); ++i) {
+            const AST& operand = operands[i];
+            if (IsLiteral(operand)) {
+                if (IsFalse(GetLiteralValue(operand)) == is_and) {
+                    kept.push_back(operand);
+                    break;
+                }
+                if (i + 1 < operands.size()) {
+                    continue;
+                }
+            }
+            kept.push_back(operand);
+        }
+        if (kept.empty()) {
+            return MakeBoolean(is_and);
+        }
+        if (kept.size() == 1) {
+            return kept.front();
+        }
+        return Cons(operation, MakeList(kept));
+    }
+
+    // Folding is memoized by the shared node, so a repeated call runs once.
+    AST Fold(const AST& call) {
+        auto [it, inserted] = folded_.try_emplace(call.GetWord());
+        if (inserted) {
+            try {
+                AST value = fold_(call);
+                it->second = Is<Number>(value) || Is<Boolean>(value) ? value : Share(MakeQuote(value));
+            } catch (const LimitError&) {
+                // The run is out of budget, not the call in error.
+                throw;
+            } catch (const RuntimeError&) {
+                it->second = call;
+            }
+        }
+        return it->second;
+    }
+
+    AST MakeList(const std::vector<AST>& items) {
+        AST list;
+        for (auto it = items.rbegin(); it != items.rend(); ++it) {
+            list = Cons(*it, std::move(list));
+        }
+        return list;
+    }
+
+    // Hash-consing: one cell per distinct (first, second) pair.
+    AST Cons(AST first, AST second) {
+        auto key = std::make_pair(first.GetWord(), second.GetWord());
+        auto it = cells_.find(key);
+        if (it != cells_.end()) {
+            return it->second;
+        }
+        return cells_[key] = MakeCell(std::move(first), std::move(second));
+    }
+
+    // One quote per distinct datum word.
+    AST Share(const AST& quote) {
+        auto [it, inserted] = quotes_.try_emplace(As<Quote>(quote)->GetCommand().GetWord(), quote);
+        return it->second;
+    }
+
+    const Folder& fold_;
+    size_t max_depth_;
+    std::vector<Task> tasks_;
+    std::vector<AST> results_;
+    std::unordered_map<std::pair<uint64_t, uint64_t>, AST, WordPairHash> cells_;
+    std::unordered_map<uint64_t, AST> quotes_;
+    std::unordered_map<uint64_t, AST> folded_;
+};
+
+}  // namespace
+
+AST Optimize(const AST& ast, const Folder& fold, size_t max_depth) {
+    return Optimizer(fold, max_depth).Run(ast);
+}
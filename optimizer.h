@@ -0,0 +1,17 @@
+#pragma once
+
+#include "parser.h"
+#include <functional>
+
+// Evaluates a builtin call whose operands are all literals, raising
+// RuntimeError exactly where the evaluator in use would.
+using Folder = std::function<AST(const AST& call)>;
+
+// Rewrites an expression into an equivalent one that is cheaper to evaluate:
+// - builtin calls on literals are replaced by their result, computed by `fold`;
+// - arguments of and/or that cannot run or cannot change the result are dropped;
+// - identical subexpressions become one shared node and are folded only once.
+// A call that raises is kept as it is, so the error still fires if and when
+// the evaluator reaches it. Expressions nested deeper than max_depth are
+// returned unchanged, leaving the evaluator to refuse them.
+AST Optimize(const AST& ast, const Folder& fold, size_t max_depth);
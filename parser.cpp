@@ -1,102 +1,136 @@
 #include "parser.h"
+#include "symbol_table.h"
+#include <vector>
 
-AST ReadList(Tokenizer* tokenizer);
+namespace {
 
-AST Read(Tokenizer* tokenizer) {
-    Token token = tokenizer->GetToken();
-    if (std::get_if<QuoteToken>(&token)) {
-        tokenizer->Next();
-        return std::make_shared<Quote>(Read(tokenizer));
-    } else if (auto bracket_token = std::get_if<BracketToken>(&token)) {
-        if (*bracket_token == BracketToken::OPEN) {
-            tokenizer->Next();
-            return ReadList(tokenizer);
-        } else {
-            throw SyntaxError("Syntax error: got: ')' , expected: '(' ");
-        }
-    } else if (auto constant_token = std::get_if<ConstantToken>(&token)) {
-        tokenizer->Next();
-        return std::make_shared<Number>(constant_token->value);
-    } else if (auto boolean_token = std::get_if<BooleanToken>(&token)) {
-        tokenizer->Next();
-        return std::make_shared<Boolean>(boolean_token->value);
-    } else if (auto symbol_token = std::get_if<SymbolToken>(&token)) {
-        if (symbol_token->name == "quote") {
-            throw SyntaxError("Syntax error: incorrect form 'quote'");
-        } else {
-            tokenizer->Next();
-            return std::make_shared<Symbol>(symbol_token->name);
-        }
-    } else {
-        throw SyntaxError("Syntax error: unexpected token in expression");
-    }
+// An open form waiting for its next datum. Read keeps these on an explicit
+// stack instead of recursing, so input depth costs heap memory only.
+struct Frame {
+    enum class Kind {
+        kQuote,      // 'x: wrap the datum into a quote
+        kQuoteForm,  // (quote x): wrap the datum, then expect ')'
+        kElement,    // list element, pushed onto the item stack
+        kTail,       // datum after a dot, ends the list, then expect ')'
+    };
+
+    Kind kind;
+    // Where the elements of this list start on the item stack.
+    size_t start = 0;
+};
+
+bool IsBracket(const Token& token, BracketToken bracket) {
+    auto bracket_token = std::get_if<BracketToken>(&token);
+    return bracket_token && *bracket_token == bracket;
 }
 
-AST ReadList(Tokenizer* tokenizer) {
+// Cells are never modified once made, so a list is built in one go when it
+// is closed, which also lets MakeList lay its cells out contiguously.
+AST BuildList(std::vector<AST>* items, size_t start, AST tail) {
+    AST list = MakeList(std::span(*items).subspan(start), std::move(tail));
+    items->resize(start);
+    return list;
+}
 
-    Token token = tokenizer->GetToken();
-    if (auto bracket_token = std::get_if<BracketToken>(&token)) {
-        if (*bracket_token == BracketToken::CLOSE) {
-            tokenizer->Next();
-            return nullptr;
+}  // namespace
+
+AST Read(Tokenizer* tokenizer, size_t max_depth) {
+    std::vector<Frame> stack;
+    // Elements of the open lists, innermost last.
+    std::vector<AST> items;
+    auto push = [&](Frame frame) {
+        if (stack.size() >= max_depth) {
+            throw SyntaxError("Syntax error: maximum nesting depth exceeded");
         }
-    }
+        stack.push_back(std::move(frame));
+    };
 
-    if (auto symbol_token = std::get_if<SymbolToken>(&token)) {
-        if (symbol_token->name == "quote") {
+    while (true) {
+        // Read the start of a datum: either open a new frame or produce an atom.
+        AST value;
+        const Token* token = &tokenizer->GetToken();
+        if (std::get_if<QuoteToken>(token)) {
             tokenizer->Next();
-            auto output = std::make_shared<Quote>(Read(tokenizer));
-            token = tokenizer->GetToken();
-            if (auto bracket_token = std::get_if<BracketToken>(&token)) {
-                if (*bracket_token == BracketToken::CLOSE) {
+            push({Frame::Kind::kQuote});
+            continue;
+        } else if (auto bracket_token = std::get_if<BracketToken>(token)) {
+            if (*bracket_token != BracketToken::OPEN) {
+                throw SyntaxError("Syntax error: got: ')' , expected: '(' ");
+            }
+            tokenizer->Next();
+            token = &tokenizer->GetToken();
+            if (IsBracket(*token, BracketToken::CLOSE)) {
+                value = nullptr;
+            } else {
+                auto symbol_token = std::get_if<SymbolToken>(token);
+                if (symbol_token && symbol_token->name == "quote") {
                     tokenizer->Next();
-                    return output;
-                } else {
-                    throw SyntaxError("Syntax error: expected ')' in form 'quote'");
+                    push({Frame::Kind::kQuoteForm});
+                    continue;
                 }
-            } else {
-                throw SyntaxError("Syntax error: expected ')' in form 'quote'");
+                if (std::get_if<DotToken>(token)) {
+                    throw SyntaxError("Syntax error: first element of pair is skipped");
+                }
+                push({Frame::Kind::kElement, items.size()});
+                continue;
             }
-        }
-    }
-
-    std::shared_ptr<Cell> output = std::make_shared<Cell>();
-    std::shared_ptr<Cell> last = output;
-    for (token = tokenizer->GetToken();; token = tokenizer->GetToken()) {
-
-        if (std::get_if<DotToken>(&token)) {
-            throw SyntaxError("Syntax error: first element of pair is skipped");
+        } else if (auto constant_token = std::get_if<ConstantToken>(token)) {
+            value = constant_token->big.empty()
+                        ? MakeNumber(constant_token->value)
+                        : MakeNumber(BigInteger::FromDecimal(constant_token->big));
+        } else if (auto boolean_token = std::get_if<BooleanToken>(token)) {
+            value = MakeBoolean(boolean_token->value);
+        } else if (auto symbol_token = std::get_if<SymbolToken>(token)) {
+            if (symbol_token->name == "quote") {
+                throw SyntaxError("Syntax error: incorrect form 'quote'");
+            }
+            value = Value::Unmanaged(SymbolTable::Intern(symbol_token->name));
+        } else {
+            throw SyntaxError("Syntax error: unexpected token in expression");
         }
 
-        last->first_ = Read(tokenizer);
-        token = tokenizer->GetToken();
-        if (std::get_if<DotToken>(&token)) {
-            tokenizer->Next();
-            last->second_ = Read(tokenizer);
-            token = tokenizer->GetToken();
-            if (auto bracket_token = std::get_if<BracketToken>(&token)) {
-                if (*bracket_token == BracketToken::CLOSE) {
-                    tokenizer->Next();
-                    break;
-                } else {
+        // A datum is complete: hand it to the enclosing frames until one needs
+        // more input. Its last token stays current until the objects it completes
+        // are made, so an allocation that throws LimitError always leaves some of
+        // the form unread and a stream can skip the rest like a syntax error.
+        while (true) {
+            if (stack.empty()) {
+                tokenizer->Next();
+                return value;
+            }
+            Frame& frame = stack.back();
+            if (frame.kind == Frame::Kind::kQuote) {
+                value = MakeQuote(std::move(value));
+            } else if (frame.kind == Frame::Kind::kQuoteForm) {
+                tokenizer->Next();
+                if (!IsBracket(tokenizer->GetToken(), BracketToken::CLOSE)) {
+                    throw SyntaxError("Syntax error: expected ')' in form 'quote'");
+                }
+                value = MakeQuote(std::move(value));
+            } else if (frame.kind == Frame::Kind::kTail) {
+                tokenizer->Next();
+                token = &tokenizer->GetToken();
+                if (IsBracket(*token, BracketToken::OPEN)) {
                     throw SyntaxError("Syntax error: expected ')', got '('");
+                } else if (!IsBracket(*token, BracketToken::CLOSE)) {
+                    throw SyntaxError("Syntax error: expected ')'");
                 }
+                value = BuildList(&items, frame.start, std::move(value));
             } else {
-                throw SyntaxError("Syntax error: expected ')'");
-            }
-        } else if (auto bracket_token = std::get_if<BracketToken>(&token)) {
-            if (*bracket_token == BracketToken::CLOSE) {
-                last->second_ = nullptr;
+                items.push_back(std::move(value));
                 tokenizer->Next();
-                break;
-            } else {
-                last->second_ = std::make_shared<Cell>();
-                last = As<Cell>(last->second_);
+                token = &tokenizer->GetToken();
+                if (std::get_if<DotToken>(token)) {
+                    tokenizer->Next();
+                    frame.kind = Frame::Kind::kTail;
+                    break;
+                }
+                if (!IsBracket(*token, BracketToken::CLOSE)) {
+                    break;
+                }
+                value = BuildList(&items, frame.start, nullptr);
             }
-        } else {
-            last->second_ = std::make_shared<Cell>();
-            last = As<Cell>(last->second_);
+            stack.pop_back();
         }
     }
-    return output;
 }
@@ -3,6 +3,11 @@
 #include "error.h"
 #include "object.h"
 
-using AST = std::shared_ptr<Object>;
+using AST = Value;
 
-AST Read(Tokenizer* tokenizer);
+// Lists and quotes nested deeper than this raise SyntaxError.
+constexpr size_t kDefaultMaxReadDepth = 100000;
+
+// Reads one datum. The parser keeps open forms on the heap, so max_depth is
+// the only bound on how deeply the input may nest.
+AST Read(Tokenizer* tokenizer, size_t max_depth = kDefaultMaxReadDepth);
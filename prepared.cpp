@@ -0,0 +1,49 @@
+#include "prepared.h"
+#include <algorithm>
+
+// The slots of `ast` in order of first appearance, found without recursion.
+static std::vector<const Symbol*> FindSlots(const AST& ast) {
+    std::vector<const Symbol*> slots;
+    std::vector<const AST*> pending = {&ast};
+    while (!pending.empty()) {
+        const AST& value = *pending.back();
+        pending.pop_back();
+        if (Is<Quote>(value)) {
+            pending.push_back(&As<Quote>(value)->GetCommand());
+        } else if (Is<Cell>(value)) {
+            pending.push_back(&As<Cell>(value)->GetSecond());
+            pending.push_back(&As<Cell>(value)->GetFirst());
+        } else if (Is<Symbol>(value)) {
+            const Symbol* symbol = As<Symbol>(value);
+            const std::string& name = symbol->GetName();
+            if (name.size() > 1 && name[0] == '?' &&
+                std::find(slots.begin(), slots.end(), symbol) == slots.end()) {
+                slots.push_back(symbol);
+            }
+        }
+    }
+    return slots;
+}
+
+PreparedExpression::PreparedExpression(std::string_view text, size_t max_read_depth,
+                                       size_t max_depth) {
+    Tokenizer tokenizer{text};
+    ast_ = Read(&tokenizer, max_read_depth);
+    if (!tokenizer.IsEnd()) {
+        throw SyntaxError("Syntax error: extra expressions");
+    }
+    std::vector<const Symbol*> slots = FindSlots(ast_);
+    for (const Symbol* slot : slots) {
+        slot_names_.push_back(slot->GetName().substr(1));
+    }
+    // Counted whatever the options of the interpreters that execute it.
+    program_ = Compile(ast_, max_depth, slots, true);
+}
+
+size_t PreparedExpression::GetSlotIndex(std::string_view name) const {
+    auto it = std::find(slot_names_.begin(), slot_names_.end(), name);
+    if (it == slot_names_.end()) {
+        throw RuntimeError("Runtime error: no slot ?" + std::string(name));
+    }
+    return it - slot_names_.begin();
+}
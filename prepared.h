@@ -0,0 +1,39 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "bytecode.h"
+
+// An expression parsed and compiled once, then evaluated any number of times
+// with different values bound to its slots: the symbols of the form ?name.
+// Binding a value to a slot has the same effect as writing the value in its
+// place, in quoted data too. Immutable once made, so one expression may be
+// executed by interpreters on several threads at once.
+class PreparedExpression {
+public:
+    // Raises SyntaxError if `text` is not exactly one expression, and
+    // RuntimeError if it nests deeper than max_depth.
+    PreparedExpression(std::string_view text, size_t max_read_depth, size_t max_depth);
+
+    // Slot names without the '?', in order of first appearance; Execute takes
+    // their values in the same order.
+    const std::vector<std::string>& GetSlotNames() const {
+        return slot_names_;
+    }
+    // Raises RuntimeError if there is no slot `name`.
+    size_t GetSlotIndex(std::string_view name) const;
+
+    const AST& GetAst() const {
+        return ast_;
+    }
+    const Program& GetProgram() const {
+        return program_;
+    }
+
+private:
+    AST ast_;
+    std::vector<std::string> slot_names_;
+    Program program_;
+};
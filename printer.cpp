@@ -0,0 +1,173 @@
+#include "printer.h"
+#include <charconv>
+#include <iterator>
+#include <limits>
+#include <vector>
+
+namespace {
+
+class StringOutput {
+public:
+    explicit StringOutput(std::string* output) : output_(output) {
+    }
+
+    void Write(std::string_view text) {
+        output_->append(text);
+    }
+
+private:
+    std::string* output_;
+};
+
+class StreamOutput {
+public:
+    explicit StreamOutput(std::ostream* output) : output_(output) {
+    }
+
+    void Write(std::string_view text) {
+        output_->write(text.data(), text.size());
+    }
+
+private:
+    std::ostream* output_;
+};
+
+// A list or quote whose closing bracket is not written yet.
+struct Frame {
+    // The part of the list still to print, nullptr once only ")" is left.
+    const AST* rest;
+    bool first;
+};
+
+template <class Output>
+class Printer {
+public:
+    Printer(Output output, const PrintOptions& options)
+        : output_(output),
+          remaining_(options.max_size ? options.max_size : std::numeric_limits<size_t>::max()),
+          max_depth_(options.max_depth ? options.max_depth : std::numeric_limits<size_t>::max()) {
+    }
+
+    bool Print(const AST& ast);
+
+private:
+    // Writes as much of `text` as the size cap leaves room for.
+    void Write(std::string_view text) {
+        if (text.size() > remaining_) {
+            text = text.substr(0, remaining_);
+            truncated_ = true;
+        }
+        output_.Write(text);
+        remaining_ -= text.size();
+    }
+
+    void WriteNumber(const AST& value) {
+        if (!value.IsFixnum()) {
+            Write(As<Number>(value)->GetValue().ToString());
+            return;
+        }
+        char buffer[24];
+        char* end = std::to_chars(buffer, std::end(buffer), value.GetNumber()).ptr;
+        Write({buffer, end});
+    }
+
+    // Writes the atoms of `value` or opens it, then returns the value to print next.
+    const AST* Open(const AST& value, std::vector<Frame>* stack);
+
+    Output output_;
+    size_t remaining_;
+    size_t max_depth_;
+    bool truncated_ = false;
+    bool capped_ = false;
+};
+
+template <class Output>
+const AST* Printer<Output>::Open(const AST& value, std::vector<Frame>* stack) {
+    if (value == nullptr) {
+        Write("()");
+        return nullptr;
+    }
+    switch (value.GetType()) {
+        case ObjectType::kNumber:
+            WriteNumber(value);
+            return nullptr;
+        case ObjectType::kBoolean:
+            Write(value.GetBoolean() ? "#t" : "#f");
+            return nullptr;
+        case ObjectType::kSymbol:
+            Write(As<Symbol>(value)->GetName());
+            return nullptr;
+        case ObjectType::kQuote:
+        case ObjectType::kCell:
+            break;
+    }
+    if (stack->size() >= max_depth_) {
+        capped_ = true;
+        Write(kTruncated);
+        return nullptr;
+    }
+    if (Is<Quote>(value)) {
+        Write("(quote ");
+        stack->push_back({nullptr, false});
+        return &As<Quote>(value)->GetCommand();
+    }
+    Write("(");
+    stack->push_back({&value, true});
+    return nullptr;
+}
+
+// Lists are walked by following their links, an open list costs one frame
+// however long it is.
+template <class Output>
+bool Printer<Output>::Print(const AST& ast) {
+    // Reused by every print of the thread, a warm printer allocates nothing.
+    static thread_local std::vector<Frame> stack;
+    stack.clear();
+    const AST* next = Open(ast, &stack);
+    while (!truncated_) {
+        if (next) {
+            next = Open(*next, &stack);
+            continue;
+        }
+        if (stack.empty()) {
+            break;
+        }
+        Frame& top = stack.back();
+        if (top.rest == nullptr || *top.rest == nullptr) {
+            Write(")");
+            stack.pop_back();
+        } else if (!Is<Cell>(*top.rest)) {
+            Write(" . ");
+            next = top.rest;
+            top.rest = nullptr;
+        } else {
+            if (!top.first) {
+                Write(" ");
+            }
+            const Cell* cell = As<Cell>(*top.rest);
+            top.first = false;
+            top.rest = &cell->GetSecond();
+            next = &cell->GetFirst();
+        }
+    }
+    if (truncated_) {
+        output_.Write(kTruncated);
+    }
+    return !truncated_ && !capped_;
+}
+
+}  // namespace
+
+bool Print(const AST& ast, std::string* output, const PrintOptions& options) {
+    return Printer(StringOutput(output), options).Print(ast);
+}
+
+bool Print(const AST& ast, std::ostream* output, const PrintOptions& options) {
+    return Printer(StreamOutput(output), options).Print(ast);
+}
+
+std::string AsString(const AST& ast) {
+    std::string output;
+    Print(ast, &output);
+    return output;
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <string_view>
+
+#include "parser.h"
+
+// Caps on the printed form of a value, zero leaves it unbounded. A capped
+// print ends with kTruncated where the value was cut.
+struct PrintOptions {
+    // Bytes written before kTruncated.
+    size_t max_size = 0;
+    // Lists and quotes nested deeper than this are replaced by kTruncated.
+    size_t max_depth = 0;
+};
+
+inline constexpr std::string_view kTruncated = "...";
+
+// Appends the printed form of `ast` to the output. Nothing is formatted into
+// temporary strings except boxed numbers, and nested values are walked with
+// an explicit stack, so printing a deep value uses no native recursion.
+// Returns false if a cap cut the output short.
+bool Print(const AST& ast, std::string* output, const PrintOptions& options = {});
+bool Print(const AST& ast, std::ostream* output, const PrintOptions& options = {});
+
+// Prints a value the way Run returns it.
+std::string AsString(const AST& ast);
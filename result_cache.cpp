@@ -0,0 +1,109 @@
+#include "result_cache.h"
+#include <vector>
+
+ResultCache::ResultCache(size_t max_bytes) : max_bytes_(max_bytes) {
+}
+
+size_t ResultCache::GetCost(const Entry& entry) {
+    return kEntryOverhead + entry.key.size() + entry.result.output.size();
+}
+
+const BatchResult* ResultCache::Find(std::string_view key) {
+    auto it = index_.find(key);
+    if (it == index_.end()) {
+        ++stats_.misses;
+        return nullptr;
+    }
+    ++stats_.hits;
+    entries_.splice(entries_.begin(), entries_, it->second);
+    return &it->second->result;
+}
+
+void ResultCache::Insert(std::string key, BatchResult result) {
+    Entry entry{std::move(key), std::move(result)};
+    size_t cost = GetCost(entry);
+    if (cost > max_bytes_ || index_.contains(entry.key)) {
+        return;
+    }
+    while (stats_.bytes + cost > max_bytes_) {
+        const Entry& victim = entries_.back();
+        stats_.bytes -= GetCost(victim);
+        index_.erase(victim.key);
+        entries_.pop_back();
+        ++stats_.evictions;
+    }
+    entries_.push_front(std::move(entry));
+    index_.emplace(entries_.front().key, entries_.begin());
+    stats_.bytes += cost;
+    stats_.entries = entries_.size();
+}
+
+const CacheStats& ResultCache::GetStats() const {
+    return stats_;
+}
+
+template <class T>
+static void AppendBytes(std::string* key, T value) {
+    key->append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void MakeStructuralKey(const AST& ast, std::string* key) {
+    key->clear();
+    std::vector<const AST*> stack = {&ast};
+    while (!stack.empty()) {
+        const AST& value = *stack.back();
+        stack.pop_back();
+        if (value == nullptr) {
+            key->push_back('n');
+            continue;
+        }
+        switch (value.GetType()) {
+            case ObjectType::kNumber: {
+                if (value.IsFixnum()) {
+                    key->push_back('i');
+                    AppendBytes(key, value.GetNumber());
+                    break;
+                }
+                BigInteger big = As<Number>(value)->GetValue();
+                key->push_back(big.IsNegative() ? '-' : '+');
+                AppendBytes(key, big.GetLimbs().size());
+                for (uint32_t limb : big.GetLimbs()) {
+                    AppendBytes(key, limb);
+                }
+                break;
+            }
+            case ObjectType::kBoolean:
+                key->push_back(value.GetBoolean() ? 't' : 'f');
+                break;
+            case ObjectType::kSymbol:
+                key->push_back('s');
+                AppendBytes(key, As<Symbol>(value)->GetId());
+                break;
+            case ObjectType::kQuote:
+                key->push_back('q');
+                stack.push_back(&As<Quote>(value)->GetCommand());
+                break;
+            case ObjectType::kCell:
+                key->push_back('c');
+                stack.push_back(&As<Cell>(value)->GetSecond());
+                stack.push_back(&As<Cell>(value)->GetFirst());
+                break;
+        }
+    }
+}
+
+const std::string& Unpack(const BatchResult& result) {
+    switch (result.status) {
+        case BatchResult::Status::kOk:
+            break;
+        case BatchResult::Status::kSyntaxError:
+            throw SyntaxError(result.output);
+        case BatchResult::Status::kRuntimeError:
+            throw RuntimeError(result.output);
+        case BatchResult::Status::kNameError:
+            throw NameError(result.output);
+        case BatchResult::Status::kLimitError:
+            throw LimitError(result.output);
+    }
+    return result.output;
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <list>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include "error.h"
+#include "parser.h"
+
+// Outcome of one expression of a batch or a stream: the printed result on
+// kOk, the error message otherwise.
+struct BatchResult {
+    enum class Status { kOk, kSyntaxError, kRuntimeError, kNameError, kLimitError };
+
+    Status status;
+    std::string output;
+};
+
+struct CacheStats {
+    size_t hits = 0;
+    size_t misses = 0;
+    size_t evictions = 0;
+    size_t entries = 0;
+    size_t bytes = 0;
+};
+
+// Least recently used map from the structural key of an expression to its
+// outcome. Input that differs only in whitespace or in 'x versus (quote x)
+// parses to the same AST and so shares an entry. Keys are compared in full,
+// a hash collision never returns a foreign result.
+class ResultCache {
+public:
+    // Rough per-entry cost of the list and hash nodes, charged on top of the strings.
+    static constexpr size_t kEntryOverhead = 128;
+
+    explicit ResultCache(size_t max_bytes);
+
+    ResultCache(const ResultCache&) = delete;
+    ResultCache& operator=(const ResultCache&) = delete;
+
+    // Returns nullptr on a miss. The result stays valid until the next Insert.
+    const BatchResult* Find(std::string_view key);
+
+    // Evicts the least recently used entries until the new one fits the budget.
+    // An entry larger than the whole budget is not stored.
+    void Insert(std::string key, BatchResult result);
+
+    const CacheStats& GetStats() const;
+
+private:
+    struct Entry {
+        std::string key;
+        BatchResult result;
+    };
+
+    static size_t GetCost(const Entry& entry);
+
+    size_t max_bytes_;
+    // Most recently used first.
+    std::list<Entry> entries_;
+    // Keys view the strings owned by the entries.
+    std::unordered_map<std::string_view, std::list<Entry>::iterator> index_;
+    CacheStats stats_;
+};
+
+// Encodes the structure of an AST into `key`: a type byte per node, followed by
+// the value of a number or boolean or the id of a symbol, cells in preorder.
+// Equal keys mean structurally equal expressions. Cheaper than printing the
+// AST since nothing is formatted as text.
+void MakeStructuralKey(const AST& ast, std::string* key);
+
+// Returns the output of a kOk result, otherwise throws the error it records.
+const std::string& Unpack(const BatchResult& result);
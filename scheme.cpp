@@ -1,67 +1,330 @@
 #include "scheme.h"
 #include "parser.h"
 #include "applier.h"
-#include <sstream>
+#include "optimizer.h"
+#include "thread_pool.h"
+#include "cons_table.h"
+#include "binary_ast.h"
+#include <optional>
 #include <vector>
 
-std::string AsString(AST ast) {
-    if (ast == nullptr) {
-        return "()";
+Interpreter::Interpreter(InterpreterOptions options)
+    : options_(options), vm_(options.max_depth), cache_(options.cache_bytes) {
+}
+
+Interpreter::~Interpreter() = default;
+
+// Runs `evaluate` and turns the interpreter errors it throws into a result.
+template <class F>
+static BatchResult CaptureErrors(F&& evaluate) {
+    try {
+        return {BatchResult::Status::kOk, evaluate()};
+    } catch (const SyntaxError& error) {
+        return {BatchResult::Status::kSyntaxError, error.what()};
+    } catch (const LimitError& error) {
+        return {BatchResult::Status::kLimitError, error.what()};
+    } catch (const RuntimeError& error) {
+        return {BatchResult::Status::kRuntimeError, error.what()};
+    } catch (const NameError& error) {
+        return {BatchResult::Status::kNameError, error.what()};
+    }
+}
+
+// Drops what is left of a datum the parser rejected, so that reading resumes
+// at the next top-level form. `balance` is the bracket balance at its start.
+static void SkipMalformed(Tokenizer* tokenizer, int64_t balance) {
+    // The rejected token itself always goes, even at the top level.
+    bool skipped = false;
+    while (!tokenizer->IsEnd() && (!skipped || tokenizer->GetBracketBalance() > balance)) {
+        tokenizer->Next();
+        skipped = true;
+    }
+}
+
+AST Interpreter::Evaluate(const AST& ast) {
+    if (options_.mode == EvalMode::kTreeWalk) {
+        if (options_.optimize) {
+            Folder fold = [this](const AST& call) {
+                return Applier::Apply(call, options_.max_depth);
+            };
+            return Applier::Apply(Optimize(ast, fold, options_.max_depth), options_.max_depth);
+        }
+        return Applier::Apply(ast, options_.max_depth);
+    }
+    if (options_.optimize) {
+        Folder fold = [this](const AST& call) {
+            return vm_.Run(Compile(call, options_.max_depth, {}, options_.metrics));
+        };
+        return vm_.Run(Compile(Optimize(ast, fold, options_.max_depth), options_.max_depth, {},
+                               options_.metrics));
+    }
+    return vm_.Run(Compile(ast, options_.max_depth, {}, options_.metrics));
+}
+
+std::string Interpreter::Run(std::string_view expr) {
+    std::string output;
+    Run(expr, &output);
+    return output;
+}
+
+Metrics* Interpreter::GetCollector() {
+    return options_.metrics ? &metrics_ : nullptr;
+}
+
+template <class F>
+void Interpreter::CountErrors(F&& run) {
+    if (!options_.metrics) {
+        run();
+        return;
+    }
+    try {
+        run();
+    } catch (const SyntaxError&) {
+        metrics_.CountError(BatchResult::Status::kSyntaxError);
+        throw;
+    } catch (const LimitError&) {
+        metrics_.CountError(BatchResult::Status::kLimitError);
+        throw;
+    } catch (const RuntimeError&) {
+        metrics_.CountError(BatchResult::Status::kRuntimeError);
+        throw;
+    } catch (const NameError&) {
+        metrics_.CountError(BatchResult::Status::kNameError);
+        throw;
+    }
+}
+
+void Interpreter::Run(std::string_view expr, std::string* output) {
+    Run(expr, output, options_.limits);
+}
+
+void Interpreter::Run(std::string_view expr, std::string* output, const RunLimits& limits) {
+    CountErrors([&] {
+        // Declared first so that every value of this call is gone when the arena is reset.
+        std::optional<ArenaScope> arena_scope;
+        if (options_.use_arena) {
+            arena_scope.emplace(&arena_);
+        }
+        HashConsScope hash_cons_scope(options_.hash_cons);
+        MetricsScope metrics_scope(GetCollector());
+        std::optional<Budget> budget;
+        if (limits.IsBounded() || options_.account_memory) {
+            budget.emplace(limits, &memory_stats_);
+        }
+        BudgetScope budget_scope(budget ? &*budget : nullptr);
+
+        Tokenizer tokenizer{expr};
+
+        AST ast;
+        {
+            StageTimer timer(GetCollector(), Stage::kRead);
+            ast = Read(&tokenizer, options_.max_read_depth);
+            if (!tokenizer.IsEnd()) {
+                throw SyntaxError("Syntax error: extra expressions");
+            }
+        }
+
+        RunParsed(ast, output);
+    });
+}
+
+// Stages are timed as they run, a cache hit skips both.
+void Interpreter::RunParsed(const AST& ast, std::string* output) {
+    auto evaluate_and_print = [&] {
+        AST result;
+        {
+            StageTimer timer(GetCollector(), Stage::kEvaluate);
+            result = Evaluate(ast);
+        }
+        StageTimer timer(GetCollector(), Stage::kPrint);
+        output->clear();
+        Print(result, output, options_.print);
+    };
+    if (options_.cache_bytes == 0) {
+        evaluate_and_print();
+        return;
+    }
+    std::string key;
+    MakeStructuralKey(ast, &key);
+    if (const BatchResult* cached = cache_.Find(key)) {
+        output->assign(Unpack(*cached));
+        return;
+    }
+    BatchResult result = CaptureErrors([&] {
+        evaluate_and_print();
+        return *output;
+    });
+    // Running out of budget says nothing about the expression.
+    if (result.status != BatchResult::Status::kLimitError) {
+        cache_.Insert(std::move(key), result);
     }
-    if (Is<Number>(ast)) {
-        auto number = As<Number>(ast)->GetValue();
-        return std::to_string(number);
-    } else if (Is<Boolean>(ast)) {
-        auto boolean = As<Boolean>(ast)->GetValue();
-        return boolean ? "#t" : "#f";
-    } else if (Is<Quote>(ast)) {
-        std::string ans = "(quote ";
-        ans += AsString(As<Quote>(ast)->GetCommand());
-        ans += ")";
-        return ans;
-    } else if (Is<Symbol>(ast)) {
-        return As<Symbol>(ast)->GetName();
-    } else if (Is<Cell>(ast)) {
-        std::vector<std::string> all;
-        auto operand = ast;
-        while (operand) {
-            if (!Is<Cell>(operand)) {
-                all.push_back(". " + AsString(operand));
-                break;
+    // Rethrows a recorded error, the output is already written otherwise.
+    Unpack(result);
+}
+
+std::shared_ptr<const PreparedExpression> Interpreter::Prepare(std::string_view expr) {
+    std::shared_ptr<const PreparedExpression> prepared;
+    CountErrors([&] {
+        // Outlives any run, so never taken from the arena.
+        HashConsScope hash_cons_scope(options_.hash_cons);
+        MetricsScope metrics_scope(GetCollector());
+        StageTimer timer(GetCollector(), Stage::kRead);
+        prepared = std::make_shared<const PreparedExpression>(expr, options_.max_read_depth,
+                                                              options_.max_depth);
+    });
+    return prepared;
+}
+
+void Interpreter::Execute(const PreparedExpression& prepared, std::span<const AST> args,
+                          std::string* output) {
+    CountErrors([&] {
+        if (args.size() != prepared.GetSlotNames().size()) {
+            throw RuntimeError("Runtime error: wrong number of arguments in prepared expression");
+        }
+        std::optional<ArenaScope> arena_scope;
+        // Arena objects must not point to counted ones, see Arena.
+        std::vector<AST> arena_args;
+        if (options_.use_arena) {
+            arena_scope.emplace(&arena_);
+            for (const AST& arg : args) {
+                arena_args.push_back(arg.IsFixnum() || !Is<Number>(arg)
+                                         ? arg
+                                         : MakeNumber(arg.GetBigInteger()));
+            }
+            args = arena_args;
+        }
+        HashConsScope hash_cons_scope(options_.hash_cons);
+        MetricsScope metrics_scope(GetCollector());
+        std::optional<Budget> budget;
+        if (options_.limits.IsBounded() || options_.account_memory) {
+            budget.emplace(options_.limits, &memory_stats_);
+        }
+        BudgetScope budget_scope(budget ? &*budget : nullptr);
+
+        // Anything else would not evaluate to itself, unlike its text.
+        for (const AST& arg : args) {
+            if (!Is<Number>(arg) && !Is<Boolean>(arg)) {
+                throw RuntimeError("Runtime error: slot values must be numbers or booleans");
+            }
+        }
+        AST result;
+        {
+            StageTimer timer(GetCollector(), Stage::kEvaluate);
+            const Program& program = prepared.GetProgram();
+            if (options_.mode == EvalMode::kTreeWalk) {
+                result = Applier::Apply(BindSlots(prepared.GetAst(), program.slots, args),
+                                        options_.max_depth);
             } else {
-                if (As<Cell>(operand)->GetFirst() == nullptr) {
-                    all.push_back("()");
-                } else {
-                    all.push_back(AsString(As<Cell>(operand)->GetFirst()));
-                }
-                operand = As<Cell>(operand)->GetSecond();
+                result = vm_.Run(program, args);
             }
         }
-        std::string ans;
-        ans = "(";
-        for (size_t i = 0; i < all.size(); ++i) {
-            if (i > 0) {
-                ans += " ";
+        StageTimer timer(GetCollector(), Stage::kPrint);
+        output->clear();
+        Print(result, output, options_.print);
+    });
+}
+
+std::string Interpreter::Execute(const PreparedExpression& prepared,
+                                 std::initializer_list<int64_t> args) {
+    std::vector<AST> values;
+    for (int64_t arg : args) {
+        values.push_back(MakeNumber(arg));
+    }
+    std::string output;
+    Execute(prepared, values, &output);
+    return output;
+}
+
+const CacheStats& Interpreter::GetCacheStats() const {
+    return cache_.GetStats();
+}
+
+const MemoryStats& Interpreter::GetMemoryStats() const {
+    return memory_stats_;
+}
+
+Metrics Interpreter::GetMetrics() const {
+    Metrics metrics = metrics_;
+    for (const auto& worker : workers_) {
+        metrics.Merge(worker->GetMetrics());
+    }
+    return metrics;
+}
+
+template <class ReadForm, class SkipForm>
+BatchResult Interpreter::RunForm(ReadForm&& read, SkipForm&& skip) {
+    BatchResult result = CaptureErrors([&] {
+        std::optional<ArenaScope> arena_scope;
+        if (options_.use_arena) {
+            arena_scope.emplace(&arena_);
+        }
+
+        std::optional<Budget> budget;
+        std::optional<BudgetScope> budget_scope;
+        AST ast;
+        // Either error leaves the form partly read, or not read at all.
+        try {
+            if (options_.limits.IsBounded() || options_.account_memory) {
+                budget.emplace(options_.limits, &memory_stats_);
+                budget_scope.emplace(&*budget);
             }
-            ans += all[i];
+            StageTimer timer(GetCollector(), Stage::kRead);
+            ast = read();
+        } catch (const SyntaxError&) {
+            skip();
+            throw;
+        } catch (const LimitError&) {
+            skip();
+            throw;
         }
-        ans += ")";
-        return ans;
-    } else {
-        throw RuntimeError("Runtime error: unknown literal");
+        std::string output;
+        RunParsed(ast, &output);
+        return output;
+    });
+    if (options_.metrics && result.status != BatchResult::Status::kOk) {
+        metrics_.CountError(result.status);
     }
+    return result;
 }
 
-std::string Interpreter::Run(const std::string& expr) {
-    std::stringstream ss{expr};
-    Tokenizer tokenizer{&ss};
+size_t Interpreter::RunStream(InputSource* source, const ResultSink& sink) {
+    Tokenizer tokenizer{source};
+    HashConsScope hash_cons_scope(options_.hash_cons);
+    MetricsScope metrics_scope(GetCollector());
+    size_t count = 0;
+    while (!tokenizer.IsEnd()) {
+        int64_t balance = tokenizer.GetBracketBalance();
+        sink(RunForm([&] { return Read(&tokenizer, options_.max_read_depth); },
+                     [&] { SkipMalformed(&tokenizer, balance); }));
+        ++count;
+    }
+    return count;
+}
 
-    AST ast = Read(&tokenizer);
-    if (!tokenizer.IsEnd()) {
-        throw SyntaxError("Syntax error: extra expressions");
+size_t Interpreter::RunBinary(std::string_view data, const ResultSink& sink) {
+    BinaryAstReader reader(data);
+    HashConsScope hash_cons_scope(options_.hash_cons);
+    MetricsScope metrics_scope(GetCollector());
+    size_t count = 0;
+    while (!reader.IsEnd()) {
+        sink(RunForm([&] { return reader.Read(options_.max_read_depth); },
+                     [&] { reader.Skip(); }));
+        ++count;
     }
+    return count;
+}
 
-    AST result = Applier::Apply(ast);
+std::vector<BatchResult> Interpreter::RunBatch(std::span<const std::string> exprs) {
+    if (!pool_) {
+        pool_ = std::make_unique<ThreadPool>(options_.batch_threads);
+        for (size_t i = 0; i < pool_->GetThreadCount(); ++i) {
+            workers_.push_back(std::make_unique<Interpreter>(options_));
+        }
+    }
 
-    return AsString(result);
+    std::vector<BatchResult> results(exprs.size());
+    pool_->ParallelFor(exprs.size(), [&](size_t worker, size_t index) {
+        results[index] = CaptureErrors([&] { return workers_[worker]->Run(exprs[index]); });
+    });
+    return results;
 }
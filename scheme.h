@@ -1,8 +1,151 @@
 #pragma once
 
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
+#include <vector>
 
+#include "arena.h"
+#include "budget.h"
+#include "metrics.h"
+#include "prepared.h"
+#include "printer.h"
+#include "result_cache.h"
+#include "vm.h"
+
+class ThreadPool;
+
+enum class EvalMode {
+    kBytecode,  // compile to bytecode and run it on the VirtualMachine
+    kTreeWalk,  // reference evaluator, walks the AST with Applier::Apply
+};
+
+struct InterpreterOptions {
+    EvalMode mode = EvalMode::kBytecode;
+    // Allocate every object of a Run from an arena that is dropped at once when it returns.
+    bool use_arena = false;
+    // Deepest expression nesting either evaluator accepts before raising RuntimeError.
+    size_t max_depth = kDefaultMaxDepth;
+    // Deepest nesting of lists and quotes the parser accepts before raising SyntaxError.
+    size_t max_read_depth = kDefaultMaxReadDepth;
+    // Hash-cons the objects made outside the arena, see ConsTable.
+    bool hash_cons = false;
+    // Rewrite each expression with Optimize before evaluating it.
+    bool optimize = false;
+    // Memory budget in bytes of the result cache, zero disables it. Each
+    // interpreter, including every RunBatch worker, has a cache of its own.
+    size_t cache_bytes = 0;
+    // Worker threads used by RunBatch, zero means one per hardware thread.
+    size_t batch_threads = 0;
+    // Caps on the printed result of each expression.
+    PrintOptions print;
+    // Collect Metrics: builtin calls, stage latencies and errors. Off, the
+    // evaluators only test a null pointer per builtin call.
+    bool metrics = false;
+    // Bounds on each expression, from reading it to printing its result.
+    // Unbounded, the evaluators only test a null pointer per step.
+    RunLimits limits;
+    // Count the bytes of the objects each expression allocates, see
+    // GetMemoryStats. Always on while limits.max_bytes is set.
+    bool account_memory = false;
+};
+
+// Receives the outcome of each top-level form of a stream, in input order.
+using ResultSink = std::function<void(const BatchResult& result)>;
+
+// All evaluation state (VM stacks, arena) belongs to the instance and the
+// process-wide tables (symbols, builtins) are immutable or locked, so distinct
+// interpreters may Run concurrently. One instance must not be shared between
+// threads without external synchronization.
 class Interpreter {
 public:
-    std::string Run(const std::string& expr);
+    Interpreter(InterpreterOptions options = {});
+    ~Interpreter();
+
+    std::string Run(std::string_view expr);
+    std::string Run(const std::string& expr) {
+        return Run(std::string_view(expr));
+    }
+    std::string Run(const char* expr) {
+        return Run(std::string_view(expr));
+    }
+    // Replaces the contents of *output with the result. The buffer keeps its
+    // capacity, so a caller reusing one does not allocate for every result.
+    void Run(std::string_view expr, std::string* output);
+    // Runs under `limits` instead of InterpreterOptions::limits. A run that
+    // exceeds them raises LimitError and leaves *output as it was.
+    void Run(std::string_view expr, std::string* output, const RunLimits& limits);
+
+    // Evaluates independent expressions on a work-stealing thread pool and
+    // returns their results in input order. Errors are reported per item
+    // and do not stop the rest of the batch.
+    std::vector<BatchResult> RunBatch(std::span<const std::string> exprs);
+
+    // Reads top-level forms from the source one at a time, evaluates each as
+    // soon as it is complete and hands its result to the sink before reading
+    // on, so memory use does not grow with the input. A malformed form is
+    // reported as kSyntaxError and skipped up to its closing bracket. Use an
+    // FdSource for stdin or a pipe and a MappedFileSource for a file.
+    // Returns the number of forms seen.
+    size_t RunStream(InputSource* source, const ResultSink& sink);
+
+    // RunStream for a program in the binary AST format, see BinaryAstWriter:
+    // forms are loaded straight from `data` instead of being parsed, and the
+    // interned symbols keep no reference to it. Raises SyntaxError if the
+    // header is malformed or of another version; a malformed form is
+    // reported as kSyntaxError and skipped.
+    size_t RunBinary(std::string_view data, const ResultSink& sink);
+
+    // Parses and compiles `expr` once, for any number of Execute calls. The
+    // handle may be shared: interpreters on other threads may execute it too.
+    std::shared_ptr<const PreparedExpression> Prepare(std::string_view expr);
+
+    // Evaluates `prepared` with `args` bound to its slots, in the order of
+    // PreparedExpression::GetSlotNames, and replaces *output with the result.
+    // Each argument must be a number or a boolean. Runs under
+    // InterpreterOptions::limits like Run, but skips the result cache and
+    // the optimizer.
+    void Execute(const PreparedExpression& prepared, std::span<const AST> args,
+                 std::string* output);
+    std::string Execute(const PreparedExpression& prepared, std::initializer_list<int64_t> args);
+
+    // Counters of the result cache, all zero while it is disabled.
+    const CacheStats& GetCacheStats() const;
+
+    // Memory used by the last Run, or the last form of RunStream, while
+    // accounting is on: every object made by Read and by the builtins. The
+    // printer makes no objects, its output is bounded by PrintOptions.
+    const MemoryStats& GetMemoryStats() const;
+
+    // Everything collected so far, RunBatch workers included; all zero unless
+    // InterpreterOptions::metrics is set. FormatPrometheus exports it.
+    Metrics GetMetrics() const;
+
+private:
+    AST Evaluate(const AST& ast);
+    // Evaluates and prints a parsed expression, answering from the cache when it can.
+    void RunParsed(const AST& ast, std::string* output);
+    // Where this interpreter's metrics go, nullptr when it collects none.
+    Metrics* GetCollector();
+    // Runs `run`, counting the interpreter errors it throws before passing them on.
+    template <class F>
+    void CountErrors(F&& run);
+    // Reads a form of a stream with `read`, then evaluates and prints it. If
+    // reading fails, `skip` moves past whatever is left of the form.
+    template <class ReadForm, class SkipForm>
+    BatchResult RunForm(ReadForm&& read, SkipForm&& skip);
+
+    InterpreterOptions options_;
+    VirtualMachine vm_;
+    Arena arena_;
+    ResultCache cache_;
+    Metrics metrics_;
+    MemoryStats memory_stats_;
+
+    // Created by the first RunBatch, one interpreter per pool thread.
+    std::unique_ptr<ThreadPool> pool_;
+    std::vector<std::unique_ptr<Interpreter>> workers_;
 };
@@ -7,4 +7,20 @@ add_library(scheme_basic
     lexeme_types.cpp
     object.cpp
     applier.cpp
+    builtins.cpp
+    compiler.cpp
+    vm.cpp
+    symbol_table.cpp
+    arena.cpp
+    input_source.cpp
+    thread_pool.cpp
+    optimizer.cpp
+    result_cache.cpp
+    cons_table.cpp
+    big_integer.cpp
+    printer.cpp
+    metrics.cpp
+    budget.cpp
+    binary_ast.cpp
+    prepared.cpp
 )
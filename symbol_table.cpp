@@ -0,0 +1,57 @@
+#include "symbol_table.h"
+#include "builtins.h"
+#include <mutex>
+
+SymbolTable::SymbolTable() {
+    for (uint32_t id = 0; id < GetBuiltinCount(); ++id) {
+        Symbol* symbol = InternLocked(GetBuiltin(id).name);
+        builtins_.emplace(symbol->GetName(), symbol);
+    }
+}
+
+SymbolTable& SymbolTable::Instance() {
+    static SymbolTable table;
+    return table;
+}
+
+Symbol* SymbolTable::InternLocked(std::string_view name) {
+    auto it = symbols_.find(name);
+    if (it != symbols_.end()) {
+        return it->second.get();
+    }
+    auto symbol = std::make_unique<Symbol>(std::string(name), symbols_.size());
+    // The key views the name owned by the symbol itself.
+    std::string_view key = symbol->GetName();
+    return symbols_.emplace(key, std::move(symbol)).first->second.get();
+}
+
+Symbol* SymbolTable::FindBuiltin(std::string_view name) const {
+    auto it = builtins_.find(name);
+    return it == builtins_.end() ? nullptr : it->second;
+}
+
+Symbol* SymbolTable::Intern(std::string_view name) {
+    SymbolTable& table = Instance();
+    if (Symbol* builtin = table.FindBuiltin(name)) {
+        return builtin;
+    }
+    {
+        std::shared_lock lock(table.mutex_);
+        auto it = table.symbols_.find(name);
+        if (it != table.symbols_.end()) {
+            return it->second.get();
+        }
+    }
+    std::unique_lock lock(table.mutex_);
+    return table.InternLocked(name);
+}
+
+Symbol* SymbolTable::Find(std::string_view name) {
+    SymbolTable& table = Instance();
+    if (Symbol* builtin = table.FindBuiltin(name)) {
+        return builtin;
+    }
+    std::shared_lock lock(table.mutex_);
+    auto it = table.symbols_.find(name);
+    return it == table.symbols_.end() ? nullptr : it->second.get();
+}
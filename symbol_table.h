@@ -0,0 +1,35 @@
+#pragma once
+
+#include "object.h"
+#include <shared_mutex>
+#include <string_view>
+#include <unordered_map>
+
+// Process-wide table of interned symbols. Each name has exactly one Symbol
+// object, so symbols compare by pointer or by id. Builtin names are interned
+// first and in builtin table order, which makes their ids the builtin slots.
+class SymbolTable {
+public:
+    // The table keeps every symbol alive for the lifetime of the process,
+    // so symbols are referenced by unmanaged Values.
+    static Symbol* Intern(std::string_view name);
+
+    // Returns nullptr if the name was never interned.
+    static Symbol* Find(std::string_view name);
+
+private:
+    SymbolTable();
+
+    static SymbolTable& Instance();
+
+    Symbol* InternLocked(std::string_view name);
+    Symbol* FindBuiltin(std::string_view name) const;
+
+    // Builtin names, filled by the constructor and immutable afterwards. Most
+    // symbols in a program are operators, so this keeps concurrent parsers off
+    // the shared mutex.
+    std::unordered_map<std::string_view, Symbol*> builtins_;
+
+    std::shared_mutex mutex_;
+    std::unordered_map<std::string_view, std::unique_ptr<Symbol>> symbols_;
+};
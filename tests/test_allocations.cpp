@@ -0,0 +1,220 @@
+#include <catch.hpp>
+
+#include "applier.h"
+#include "scheme.h"
+#include "vm.h"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <limits>
+#include <new>
+#include <sstream>
+
+// Every allocation function is replaced, not just the plain ones: the
+// library versions of the others may come from a different allocator,
+// which sanitizers report as mismatched with the replaced delete.
+static std::atomic<size_t> allocations = 0;
+
+static void* Allocate(std::size_t size, std::size_t alignment, bool nothrow) {
+    ++allocations;
+    size = size ? size : 1;
+    void* ptr = alignment <= alignof(std::max_align_t)
+                    ? std::malloc(size)
+                    : std::aligned_alloc(alignment, (size + alignment - 1) / alignment * alignment);
+    if (!ptr && !nothrow) {
+        throw std::bad_alloc();
+    }
+    return ptr;
+}
+
+void* operator new(std::size_t size) {
+    return Allocate(size, 0, false);
+}
+void* operator new[](std::size_t size) {
+    return Allocate(size, 0, false);
+}
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size, 0, true);
+}
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept {
+    return Allocate(size, 0, true);
+}
+void* operator new(std::size_t size, std::align_val_t alignment) {
+    return Allocate(size, static_cast<std::size_t>(alignment), false);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment) {
+    return Allocate(size, static_cast<std::size_t>(alignment), false);
+}
+void* operator new(std::size_t size, std::align_val_t alignment, const std::nothrow_t&) noexcept {
+    return Allocate(size, static_cast<std::size_t>(alignment), true);
+}
+void* operator new[](std::size_t size, std::align_val_t alignment,
+                     const std::nothrow_t&) noexcept {
+    return Allocate(size, static_cast<std::size_t>(alignment), true);
+}
+
+void operator delete(void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::size_t, std::align_val_t) noexcept {
+    std::free(ptr);
+}
+void operator delete(void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+void operator delete[](void* ptr, std::align_val_t, const std::nothrow_t&) noexcept {
+    std::free(ptr);
+}
+
+static AST Parse(const std::string& expr) {
+    std::stringstream ss{expr};
+    Tokenizer tokenizer{&ss};
+    return Read(&tokenizer);
+}
+
+template <class F>
+static size_t CountAllocations(F&& f) {
+    size_t before = allocations;
+    f();
+    return allocations - before;
+}
+
+static const std::vector<std::string> kExpressions = {
+    "(number? 1)", "(number? '(1))", "(boolean? #t)", "(not #f)", "(not 1)",
+    "(null? '())", "(pair? '(1 2))", "(list? '(1 2))", "(list? 1)", "(= 1 1 2)",
+    "(< 1 2 3)", "(>= 3 3 1)", "(and 1 #f)", "(or #f (< 1 2))", "(+ 1 (* 2 3))",
+    "(- 1024 2048)", "(max (abs -5) (min 3 7))", "(* 1000000 1000000 1000000)"};
+
+TEST_CASE("Predicates and small arithmetic allocate nothing in the VM") {
+    VirtualMachine vm;
+    for (const auto& expr : kExpressions) {
+        INFO(expr);
+        Program program = Compile(Parse(expr));
+        vm.Run(program);  // sizes the VM stack
+        REQUIRE(CountAllocations([&] { vm.Run(program); }) == 0);
+    }
+}
+
+TEST_CASE("Predicates and small arithmetic allocate nothing in the tree-walker") {
+    for (const auto& expr : kExpressions) {
+        INFO(expr);
+        AST ast = Parse(expr);
+        Applier::Apply(ast);  // sizes the tree-walker stacks
+        REQUIRE(CountAllocations([&] { Applier::Apply(ast); }) == 0);
+    }
+}
+
+TEST_CASE("List access allocates nothing in either evaluator") {
+    const char* exprs[] = {"(list-ref '(1 2 3) 2)", "(list-tail '(1 2 3) 1)", "(car '(1 2))",
+                           "(cdr '(1 2))", "(list? '(1 2))", "(list 1 2 3)"};
+    VirtualMachine vm;
+    for (const char* expr : exprs) {
+        INFO(expr);
+        AST ast = Parse(expr);
+        Program program = Compile(ast);
+        vm.Run(program);
+        Applier::Apply(ast);
+        REQUIRE(CountAllocations([&] { vm.Run(program); }) == 0);
+        REQUIRE(CountAllocations([&] { Applier::Apply(ast); }) == 0);
+    }
+}
+
+TEST_CASE("Printing into a warm buffer allocates nothing") {
+    AST ast = Parse("(1 (a . -2) '(#t ()) 4611686018427387903)");
+    std::string output;
+    Print(ast, &output);
+    REQUIRE(CountAllocations([&] {
+                output.clear();
+                Print(ast, &output);
+            }) == 0);
+    REQUIRE(output == "(1 (a . -2) (quote (#t ())) 4611686018427387903)");
+}
+
+TEST_CASE("Booleans and fixnums are immediate") {
+    REQUIRE(CountAllocations([] { MakeBoolean(true); }) == 0);
+    REQUIRE(CountAllocations([] { MakeNumber(Value::kMinFixnum); }) == 0);
+    REQUIRE(CountAllocations([] { MakeNumber(Value::kMaxFixnum); }) == 0);
+    REQUIRE(MakeBoolean(true) == MakeBoolean(true));
+    REQUIRE(MakeBoolean(true) != MakeBoolean(false));
+    REQUIRE(MakeNumber(Value::kMaxFixnum) == MakeNumber(Value::kMaxFixnum));
+    REQUIRE(MakeNumber(Value::kMaxFixnum).GetNumber() == Value::kMaxFixnum);
+    REQUIRE(MakeNumber(Value::kMinFixnum).GetNumber() == Value::kMinFixnum);
+    REQUIRE(MakeNumber(-1).GetNumber() == -1);
+
+    REQUIRE(Parse("#t") == MakeBoolean(true));
+    REQUIRE(Parse("42") == MakeNumber(42));
+    REQUIRE(Parse("-1024") == MakeNumber(-1024));
+}
+
+TEST_CASE("Numbers outside the fixnum range are boxed") {
+    auto max = std::numeric_limits<int64_t>::max();
+    auto min = std::numeric_limits<int64_t>::min();
+    REQUIRE(CountAllocations([&] { MakeNumber(max); }) == 1);
+    REQUIRE(MakeNumber(max).IsObject());
+    REQUIRE(Is<Number>(MakeNumber(max)));
+    REQUIRE(MakeNumber(max).GetNumber() == max);
+    REQUIRE(MakeNumber(min).GetNumber() == min);
+    REQUIRE(MakeNumber(Value::kMaxFixnum + 1).GetNumber() == Value::kMaxFixnum + 1);
+}
+
+TEST_CASE("Objects made inside an arena scope come from the arena") {
+    Arena arena;
+    {
+        ArenaScope scope(&arena);
+        REQUIRE(Arena::Current() == &arena);
+        MakeCell(nullptr, nullptr);  // reserves the first block
+        Value list;
+        REQUIRE(CountAllocations([&] {
+                    for (int i = 0; i < 100; ++i) {
+                        list = MakeCell(MakeNumber(i), MakeQuote(list));
+                    }
+                }) == 0);
+        REQUIRE(list.IsObject());
+        REQUIRE(As<Cell>(list)->GetFirst().GetNumber() == 99);
+        REQUIRE(arena.GetBytesAllocated() > 0);
+    }
+    REQUIRE(Arena::Current() == nullptr);
+    REQUIRE(arena.GetBytesAllocated() == 0);
+}
+
+TEST_CASE("Interpreter reuses its arena across runs") {
+    std::string list = "'(";
+    for (int i = 0; i < 10000; ++i) {
+        list += std::to_string(i) + " (quote x) ";
+    }
+    list += ")";
+
+    Interpreter heap;
+    Interpreter arena({.use_arena = true});
+    std::string expected = heap.Run(list);
+    for (int i = 0; i < 3; ++i) {
+        REQUIRE(arena.Run(list) == expected);
+        REQUIRE(arena.Run("(list-tail (cons 1 '(2 3)) 1)") == "(2 3)");
+        REQUIRE_THROWS_AS(arena.Run("(car '())"), RuntimeError);
+    }
+}
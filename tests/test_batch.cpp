@@ -0,0 +1,89 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+#include "thread_pool.h"
+
+#include <atomic>
+
+TEST_CASE("ParallelFor visits every index once") {
+    for (size_t threads : {1, 3, 8}) {
+        ThreadPool pool(threads);
+        REQUIRE(pool.GetThreadCount() == threads);
+        for (size_t count : {0, 1, 7, 1000}) {
+            std::vector<std::atomic<int>> visits(count);
+            std::atomic<bool> worker_in_range = true;
+            pool.ParallelFor(count, [&](size_t worker, size_t index) {
+                worker_in_range = worker_in_range && worker < threads;
+                ++visits[index];
+            });
+            REQUIRE(worker_in_range);
+            for (const auto& visit : visits) {
+                REQUIRE(visit == 1);
+            }
+        }
+    }
+}
+
+TEST_CASE("ParallelFor rethrows the first exception after draining") {
+    ThreadPool pool(4);
+    std::atomic<size_t> calls = 0;
+    REQUIRE_THROWS_AS(pool.ParallelFor(100,
+                                       [&](size_t, size_t index) {
+                                           ++calls;
+                                           if (index % 10 == 3) {
+                                               throw std::logic_error("boom");
+                                           }
+                                       }),
+                      std::logic_error);
+    REQUIRE(calls == 100);
+    pool.ParallelFor(10, [&](size_t, size_t) { ++calls; });
+    REQUIRE(calls == 110);
+}
+
+TEST_CASE("RunBatch keeps input order and reports errors per item") {
+    for (bool use_arena : {false, true}) {
+        Interpreter interpreter({.use_arena = use_arena, .batch_threads = 4});
+        std::vector<std::string> exprs;
+        for (int i = 0; i < 2000; ++i) {
+            switch (i % 4) {
+                case 0:
+                    exprs.push_back("(+ " + std::to_string(i) + " 1)");
+                    break;
+                case 1:
+                    exprs.push_back("(car '())");
+                    break;
+                case 2:
+                    exprs.push_back("(+ 1");
+                    break;
+                default:
+                    exprs.push_back("'(" + std::to_string(i) + " . x)");
+                    break;
+            }
+        }
+
+        for (int round = 0; round < 2; ++round) {
+            auto results = interpreter.RunBatch(exprs);
+            REQUIRE(results.size() == exprs.size());
+            for (int i = 0; i < 2000; ++i) {
+                const auto& result = results[i];
+                switch (i % 4) {
+                    case 0:
+                        REQUIRE(result.status == BatchResult::Status::kOk);
+                        REQUIRE(result.output == std::to_string(i + 1));
+                        break;
+                    case 1:
+                        REQUIRE(result.status == BatchResult::Status::kRuntimeError);
+                        break;
+                    case 2:
+                        REQUIRE(result.status == BatchResult::Status::kSyntaxError);
+                        break;
+                    default:
+                        REQUIRE(result.status == BatchResult::Status::kOk);
+                        REQUIRE(result.output == "(" + std::to_string(i) + " . x)");
+                        break;
+                }
+            }
+        }
+    }
+    REQUIRE(Interpreter().RunBatch({}).empty());
+}
@@ -0,0 +1,180 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+#include "parser.h"
+#include "cons_table.h"
+
+#include <random>
+
+static AST Parse(std::string_view text) {
+    Tokenizer tokenizer{text};
+    return Read(&tokenizer);
+}
+
+static BigInteger Big(std::string_view text) {
+    return BigInteger::FromDecimal(text);
+}
+
+static std::string ToString(__int128 value) {
+    if (value == 0) {
+        return "0";
+    }
+    unsigned __int128 magnitude = value < 0 ? -static_cast<unsigned __int128>(value) : value;
+    std::string digits;
+    for (; magnitude != 0; magnitude /= 10) {
+        digits.insert(digits.begin(), static_cast<char>('0' + magnitude % 10));
+    }
+    return value < 0 ? "-" + digits : digits;
+}
+
+TEST_CASE("BigInteger converts to and from decimal") {
+    for (const char* text : {"0", "1", "-1", "4294967296", "-9223372036854775809",
+                             "1000000000000000000000000000000000000",
+                             "1606938044258990275541962092341162602522202993782792835301376"}) {
+        REQUIRE(Big(text).ToString() == text);
+    }
+    REQUIRE(Big("000123").ToString() == "123");
+    REQUIRE(Big("-0").ToString() == "0");
+    REQUIRE(!Big("-0").IsNegative());
+    REQUIRE(BigInteger(INT64_MIN).ToString() == "-9223372036854775808");
+
+    int64_t value = 0;
+    REQUIRE(BigInteger(INT64_MIN).ToInt64(&value));
+    REQUIRE(value == INT64_MIN);
+    REQUIRE(Big("9223372036854775807").ToInt64(&value));
+    REQUIRE(value == INT64_MAX);
+    REQUIRE(!Big("9223372036854775808").ToInt64(&value));
+    REQUIRE(!Big("-9223372036854775809").ToInt64(&value));
+}
+
+TEST_CASE("BigInteger kernels agree with 128-bit arithmetic") {
+    std::mt19937_64 random(7);
+    for (int i = 0; i < 20000; ++i) {
+        // Random widths, so that single limb divisors and carries across limbs show up.
+        auto lhs = static_cast<int64_t>(random() >> (1 + random() % 63));
+        auto rhs = static_cast<int64_t>(random() >> (1 + random() % 63));
+        lhs = random() % 2 ? lhs : -lhs;
+        rhs = random() % 2 ? rhs : -rhs;
+        __int128 product = static_cast<__int128>(lhs) * rhs;
+        INFO(lhs << " " << rhs);
+        REQUIRE((BigInteger(lhs) + BigInteger(rhs)).ToString() ==
+                ToString(static_cast<__int128>(lhs) + rhs));
+        REQUIRE((BigInteger(lhs) - BigInteger(rhs)).ToString() ==
+                ToString(static_cast<__int128>(lhs) - rhs));
+        REQUIRE((BigInteger(lhs) * BigInteger(rhs)).ToString() == ToString(product));
+        REQUIRE(Compare(BigInteger(lhs), BigInteger(rhs)) == (lhs < rhs ? -1 : lhs > rhs));
+        if (rhs != 0) {
+            REQUIRE((Big(ToString(product)) / BigInteger(rhs)).ToString() == std::to_string(lhs));
+            REQUIRE((Big(ToString(product + 1)) / BigInteger(rhs)).ToString() ==
+                    ToString((product + 1) / rhs));
+        }
+    }
+}
+
+TEST_CASE("BigInteger divides multi-limb numbers") {
+    BigInteger power = Big("1606938044258990275541962092341162602522202993782792835301376");
+    BigInteger divisor = Big("515377520732011331036461129765621272702107522001");
+    REQUIRE((power / divisor).ToString() == "3117982410207");
+    REQUIRE((-power / divisor).ToString() == "-3117982410207");
+    REQUIRE((divisor / power).ToString() == "0");
+    REQUIRE((Big("10000000000000000000000000000000000000000") / Big("12345678901234567890"))
+                .ToString() == "810000007290000066347");
+
+    BigInteger x = Big("123456789012345678901234567890");
+    REQUIRE((x * x).ToString() == "15241578753238836750495351562536198787501905199875019052100");
+    REQUIRE((x * x / (x + BigInteger(1))).ToString() == "123456789012345678901234567889");
+    REQUIRE((x * x / x) == x);
+
+    // (q * d + r) / d == q for any remainder below the divisor.
+    std::mt19937 random(11);
+    auto make = [&random](size_t limbs) {
+        std::vector<uint32_t> digits(limbs);
+        for (uint32_t& digit : digits) {
+            digit = random() % 4 == 0 ? UINT32_MAX : random();
+        }
+        return BigInteger::FromLimbs(false, digits);
+    };
+    for (int i = 0; i < 5000; ++i) {
+        BigInteger quotient = make(1 + random() % 8);
+        BigInteger divisor = make(2 + random() % 6);
+        BigInteger remainder = divisor / make(1 + random() % 2);
+        if (Compare(remainder, divisor) >= 0) {
+            remainder = BigInteger(0);
+        }
+        REQUIRE((quotient * divisor + remainder) / divisor == quotient);
+        REQUIRE((-(quotient * divisor + remainder)) / divisor == -quotient);
+    }
+}
+
+TEST_CASE("Fixnum arithmetic promotes to big integers on overflow") {
+    Interpreter interpreter;
+    REQUIRE(interpreter.Run("(+ 4611686018427387903 1)") == "4611686018427387904");
+    REQUIRE(interpreter.Run("(+ 9223372036854775807 1)") == "9223372036854775808");
+    REQUIRE(interpreter.Run("(- -9223372036854775808 1)") == "-9223372036854775809");
+    REQUIRE(interpreter.Run("(* 9223372036854775807 9223372036854775807)") ==
+            "85070591730234615847396907784232501249");
+    REQUIRE(interpreter.Run("(* 4611686018427387903 4 1)") == "18446744073709551612");
+    REQUIRE(interpreter.Run("(/ -9223372036854775808 -1)") == "9223372036854775808");
+    REQUIRE(interpreter.Run("(/ 85070591730234615847396907784232501249 9223372036854775807)") ==
+            "9223372036854775807");
+    REQUIRE(interpreter.Run("(- 99999999999999999999 99999999999999999998)") == "1");
+    REQUIRE_THROWS_AS(interpreter.Run("(/ 99999999999999999999 0)"), RuntimeError);
+}
+
+TEST_CASE("Results that fit are fixnums again") {
+    REQUIRE(MakeNumber(BigInteger(5)) == MakeNumber(5));
+    REQUIRE(MakeNumber(Big("4611686018427387903")).IsFixnum());
+    REQUIRE(!MakeNumber(Big("4611686018427387904")).IsFixnum());
+    REQUIRE(MakeNumber(Big("-4611686018427387904")).IsFixnum());
+    REQUIRE(!MakeNumber(Big("-4611686018427387905")).IsFixnum());
+    REQUIRE(Parse("9223372036854775808").GetBigInteger() == Big("9223372036854775808"));
+    REQUIRE(IsEqual(Parse("(1 99999999999999999999)"), Parse("(1 99999999999999999999)")));
+    REQUIRE(!IsEqual(Parse("99999999999999999999"), Parse("-99999999999999999999")));
+}
+
+TEST_CASE("Big integers compare and print in every builtin") {
+    const char* exprs[] = {
+        "(< 1 99999999999999999999)",
+        "(< -99999999999999999999 -1 99999999999999999999)",
+        "(= 99999999999999999999 99999999999999999999)",
+        "(> -99999999999999999999 1)",
+        "(>= 99999999999999999999 99999999999999999998 99999999999999999999)",
+        "(abs -99999999999999999999)",
+        "(abs -4611686018427387904)",
+        "(max 1 99999999999999999999 2)",
+        "(min 1 -99999999999999999999 2)",
+        "(number? 99999999999999999999)",
+        "(list-ref '(1 2) 99999999999999999999)",
+        "(list-tail '(1 2) -99999999999999999999)",
+        "'(99999999999999999999 . -99999999999999999999)",
+        "(+ 99999999999999999999 #t)",
+        "(- 99999999999999999999)",
+    };
+    Interpreter bytecode({.mode = EvalMode::kBytecode});
+    Interpreter tree({.mode = EvalMode::kTreeWalk});
+    Interpreter arena({.use_arena = true});
+    for (const char* expr : exprs) {
+        INFO(expr);
+        std::string expected;
+        try {
+            expected = bytecode.Run(expr);
+        } catch (const RuntimeError&) {
+            REQUIRE_THROWS_AS(tree.Run(expr), RuntimeError);
+            REQUIRE_THROWS_AS(arena.Run(expr), RuntimeError);
+            continue;
+        }
+        REQUIRE(tree.Run(expr) == expected);
+        REQUIRE(arena.Run(expr) == expected);
+    }
+    REQUIRE(bytecode.Run("(< -99999999999999999999 -1 99999999999999999999)") == "#t");
+    REQUIRE(bytecode.Run("(abs -99999999999999999999)") == "99999999999999999999");
+    REQUIRE(bytecode.Run("(max 1 99999999999999999999 2)") == "99999999999999999999");
+}
+
+TEST_CASE("Big integers are hash-consed by value") {
+    HashConsScope scope;
+    AST lhs = Parse("123456789012345678901234567890");
+    AST rhs = Parse("123456789012345678901234567890");
+    REQUIRE(lhs == rhs);
+    REQUIRE(Parse("-123456789012345678901234567890") != lhs);
+}
@@ -0,0 +1,225 @@
+#include <catch.hpp>
+
+#include "binary_ast.h"
+#include "scheme.h"
+
+#include <unistd.h>
+
+using Status = BatchResult::Status;
+
+static std::vector<AST> ReadAll(const std::string& text) {
+    StringSource source(text);
+    Tokenizer tokenizer(&source);
+    std::vector<AST> forms;
+    while (!tokenizer.IsEnd()) {
+        forms.push_back(Read(&tokenizer));
+    }
+    return forms;
+}
+
+static std::string ToBinary(const std::string& text) {
+    BinaryAstWriter writer;
+    for (const AST& form : ReadAll(text)) {
+        writer.Add(form);
+    }
+    return writer.Finish();
+}
+
+static std::vector<AST> LoadAll(std::string_view binary) {
+    BinaryAstReader reader(binary);
+    std::vector<AST> forms;
+    while (!reader.IsEnd()) {
+        forms.push_back(reader.Read());
+    }
+    return forms;
+}
+
+static std::vector<BatchResult> RunBinary(Interpreter* interpreter, std::string_view binary) {
+    std::vector<BatchResult> results;
+    size_t count = interpreter->RunBinary(binary, [&](const BatchResult& result) {
+        results.push_back(result);
+    });
+    REQUIRE(count == results.size());
+    return results;
+}
+
+// The text of a '(...) list of `length` numbers.
+static std::string MakeQuotedList(size_t length) {
+    std::string list = "'(";
+    for (size_t i = 0; i < length; ++i) {
+        list += std::to_string(i) + " ";
+    }
+    return list + ")";
+}
+
+TEST_CASE("Every kind of node survives a round trip") {
+    const std::string kForms[] = {
+        "()",
+        "#t",
+        "#f",
+        "0",
+        "-1",
+        "4611686018427387903",
+        "4611686018427387904",
+        "-9223372036854775808",
+        "9223372036854775808",
+        "-123456789012345678901234567890",
+        "foo",
+        "'foo",
+        "''(a . b)",
+        "(quote (1 2))",
+        "(1 2 . 3)",
+        "(a (b (c)) . (d . e))",
+        "(+ 1 (* 2 3) (list 'x '(y z)))",
+    };
+    std::string text;
+    for (const std::string& form : kForms) {
+        text += form + "\n";
+    }
+    std::vector<AST> parsed = ReadAll(text);
+    std::string binary = ToBinary(text);
+    REQUIRE(IsBinaryAst(binary));
+    std::vector<AST> loaded = LoadAll(binary);
+    REQUIRE(loaded.size() == parsed.size());
+    for (size_t i = 0; i < parsed.size(); ++i) {
+        INFO(kForms[i]);
+        REQUIRE(IsEqual(loaded[i], parsed[i]));
+        REQUIRE(AsString(loaded[i]) == AsString(parsed[i]));
+    }
+}
+
+TEST_CASE("Long and deep forms load without recursion") {
+    std::string wide = MakeQuotedList(Cell::kMaxRunLength + 10);
+    std::string deep;
+    for (int i = 0; i < 20000; ++i) {
+        deep += "(+ 1 ";
+    }
+    deep += "0" + std::string(20000, ')');
+    for (const std::string& text : {wide, deep}) {
+        std::vector<AST> loaded = LoadAll(ToBinary(text));
+        REQUIRE(loaded.size() == 1);
+        REQUIRE(IsEqual(loaded[0], ReadAll(text)[0]));
+    }
+}
+
+TEST_CASE("Symbols are stored once and integers take varints") {
+    std::string text = "(a-long-symbol-name a-long-symbol-name a-long-symbol-name 1 2 3)";
+    std::string binary = ToBinary(text);
+    // Header, a table of one symbol, the form size, the list tag and length,
+    // then a tag and one byte per element.
+    REQUIRE(binary.size() == 5 + 1 + 1 + 18 + 1 + 2 + 6 * 2);
+    REQUIRE(binary.size() < text.size());
+}
+
+TEST_CASE("A binary program runs like its text") {
+    std::string text = "(+ 1 2) (car '(a b)) (cdr '(1 2 . 3)) (* 99999999999 99999999999) "
+                       "(and 1 '1 (+ 1 2)) (list 'x ''y) (car '()) (undefined 1)";
+    std::string binary = ToBinary(text);
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        for (bool use_arena : {false, true}) {
+            Interpreter interpreter({.mode = mode, .use_arena = use_arena});
+            std::vector<BatchResult> expected;
+            StringSource source(text);
+            interpreter.RunStream(&source, [&](const BatchResult& result) {
+                expected.push_back(result);
+            });
+            std::vector<BatchResult> results = RunBinary(&interpreter, binary);
+            REQUIRE(results.size() == 8);
+            for (size_t i = 0; i < results.size(); ++i) {
+                INFO(i);
+                REQUIRE(results[i].status == expected[i].status);
+                REQUIRE(results[i].output == expected[i].output);
+            }
+            REQUIRE(results[0].output == "3");
+            REQUIRE(results[6].status == Status::kRuntimeError);
+            REQUIRE(results[7].status != Status::kOk);
+        }
+    }
+}
+
+TEST_CASE("A mapped binary file runs in place") {
+    std::string binary = ToBinary("(+ 1 2) '(x y) (- 10 20)");
+    char path[] = "/tmp/scheme_test_binary_XXXXXX";
+    int fd = mkstemp(path);
+    REQUIRE(fd >= 0);
+    REQUIRE(write(fd, binary.data(), binary.size()) == ssize_t(binary.size()));
+    close(fd);
+    std::vector<BatchResult> results;
+    {
+        MappedFileSource source(path);
+        Interpreter interpreter;
+        results = RunBinary(&interpreter, source.NextChunk());
+    }
+    unlink(path);
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[0].output == "3");
+    REQUIRE(results[1].output == "(x y)");
+    REQUIRE(results[2].output == "-10");
+}
+
+TEST_CASE("A malformed header is rejected") {
+    std::string binary = ToBinary("(+ 1 2)");
+    Interpreter interpreter;
+    REQUIRE_THROWS_AS(RunBinary(&interpreter, "(+ 1 2)"), SyntaxError);
+    REQUIRE_THROWS_AS(RunBinary(&interpreter, binary.substr(0, 4)), SyntaxError);
+
+    std::string future = binary;
+    future[4] = kBinaryAstVersion + 1;
+    REQUIRE_THROWS_WITH(RunBinary(&interpreter, future),
+                        "Syntax error: unsupported binary AST version");
+
+    // A symbol table longer than the file.
+    std::string table = binary.substr(0, 5) + "\x05\x03" + "abc";
+    REQUIRE_THROWS_AS(RunBinary(&interpreter, table), SyntaxError);
+
+    // The parser never makes a bare quote symbol, nor does the loader.
+    std::string quote = binary.substr(0, 5) + "\x01\x05" + "quote";
+    REQUIRE_THROWS_WITH(RunBinary(&interpreter, quote), "Syntax error: incorrect form 'quote'");
+}
+
+TEST_CASE("A malformed form is reported and skipped") {
+    std::string first = ToBinary("(+ 1 2)");
+    std::string binary = ToBinary("(+ 1 2) (+ 3 4) (+ 5 6)");
+    // The second form starts where the first one ends; corrupt its list tag.
+    size_t second = first.size();
+    REQUIRE(binary[second + 1] == char(BinaryAstTag::kList));
+
+    for (char tag : {char(0x7f), char(BinaryAstTag::kQuote), char(BinaryAstTag::kSymbol)}) {
+        INFO(int(tag));
+        std::string corrupt = binary;
+        corrupt[second + 1] = tag;
+        Interpreter interpreter;
+        std::vector<BatchResult> results = RunBinary(&interpreter, corrupt);
+        REQUIRE(results.size() == 3);
+        REQUIRE(results[0].output == "3");
+        REQUIRE(results[1].status == Status::kSyntaxError);
+        REQUIRE(results[2].output == "11");
+    }
+
+    // A form size past the end leaves nothing to resynchronize on.
+    std::string truncated = binary.substr(0, binary.size() - 1);
+    Interpreter interpreter;
+    std::vector<BatchResult> results = RunBinary(&interpreter, truncated);
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[2].status == Status::kSyntaxError);
+}
+
+TEST_CASE("Loading honours the read depth and the run limits") {
+    std::string deep = std::string(100, '(') + std::string(100, ')');
+    std::string binary = ToBinary(deep + " (+ 1 2) " + MakeQuotedList(1000) + " 7");
+
+    Interpreter shallow({.max_read_depth = 50});
+    std::vector<BatchResult> results = RunBinary(&shallow, binary);
+    REQUIRE(results.size() == 4);
+    REQUIRE(results[0].status == Status::kSyntaxError);
+    REQUIRE(results[1].output == "3");
+
+    for (bool use_arena : {false, true}) {
+        Interpreter limited({.use_arena = use_arena, .limits = {.max_nodes = 500}});
+        results = RunBinary(&limited, binary);
+        REQUIRE(results.size() == 4);
+        REQUIRE(results[1].output == "3");
+        REQUIRE(results[2].status == Status::kLimitError);
+        REQUIRE(results[3].output == "7");
+    }
+}
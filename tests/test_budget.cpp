@@ -0,0 +1,149 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+
+#include <chrono>
+#include <thread>
+#include <vector>
+
+using namespace std::chrono_literals;
+using Status = BatchResult::Status;
+
+// (+ 1 (+ 1 ... 0)): about three steps per level in either evaluator.
+static std::string MakeNested(size_t depth) {
+    std::string expr;
+    for (size_t i = 0; i < depth; ++i) {
+        expr += "(+ 1 ";
+    }
+    return expr + "0" + std::string(depth, ')');
+}
+
+TEST_CASE("Budget grants exactly max_steps steps") {
+    for (uint64_t fuel : {1, 5, 1024, 1025, 5000}) {
+        INFO(fuel);
+        Budget budget({.max_steps = fuel});
+        for (uint64_t i = 0; i < fuel; ++i) {
+            budget.Step();
+        }
+        REQUIRE_THROWS_AS(budget.Step(), LimitError);
+        REQUIRE_THROWS_AS(budget.Step(), LimitError);
+    }
+}
+
+TEST_CASE("Fuel bounds both evaluators") {
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode});
+        std::string expr = MakeNested(1000);
+        std::string output = "kept";
+        REQUIRE_THROWS_AS(interpreter.Run(expr, &output, {.max_steps = 100}), LimitError);
+        REQUIRE(output == "kept");
+        interpreter.Run(expr, &output, {.max_steps = 100000});
+        REQUIRE(output == "1000");
+        // The limits of one run do not carry over to the next.
+        interpreter.Run(expr, &output);
+        REQUIRE(output == "1000");
+    }
+}
+
+TEST_CASE("The deadline stops a long evaluation") {
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode});
+        std::string output;
+        // Checked after the first kCheckInterval steps, long past the deadline.
+        REQUIRE_THROWS_WITH(interpreter.Run(MakeNested(5000), &output, {.timeout = 1ns}),
+                            "Limit error: deadline exceeded");
+        interpreter.Run(MakeNested(5000), &output, {.timeout = 1h});
+        REQUIRE(output == "5000");
+    }
+}
+
+TEST_CASE("Another thread can cancel a run") {
+    CancellationToken token;
+    Interpreter interpreter;
+    std::string output;
+    token.Cancel();
+    REQUIRE_THROWS_WITH(interpreter.Run("(+ 1 2)", &output, {.cancel = &token}),
+                        "Limit error: cancelled");
+    token.Reset();
+    interpreter.Run("(+ 1 2)", &output, {.cancel = &token});
+    REQUIRE(output == "3");
+
+    std::thread canceller([&] {
+        std::this_thread::sleep_for(10ms);
+        token.Cancel();
+    });
+    bool cancelled = false;
+    std::string expr = MakeNested(50000);
+    for (int i = 0; i < 100000 && !cancelled; ++i) {
+        try {
+            interpreter.Run(expr, &output, {.cancel = &token});
+        } catch (const LimitError&) {
+            cancelled = true;
+        }
+    }
+    canceller.join();
+    REQUIRE(cancelled);
+}
+
+TEST_CASE("max_nodes bounds the objects a run allocates") {
+    for (bool use_arena : {false, true}) {
+        Interpreter interpreter({.use_arena = use_arena});
+        std::string output;
+        // Read makes 3 cells and a quote, cons one more cell.
+        interpreter.Run("(cons 1 '())", &output, {.max_nodes = 5});
+        REQUIRE(output == "(1)");
+        REQUIRE_THROWS_AS(interpreter.Run("(cons 1 '())", &output, {.max_nodes = 4}), LimitError);
+
+        std::string list = "'(";
+        for (int i = 0; i < 1000; ++i) {
+            list += std::to_string(i) + " ";
+        }
+        list += ")";
+        REQUIRE_THROWS_AS(interpreter.Run(list, &output, {.max_nodes = 500}), LimitError);
+        interpreter.Run(list, &output, {.max_nodes = 1001});
+        REQUIRE(output.starts_with("(0 1 2"));
+        // The product is boxed.
+        std::string product = "(* 99999999999 99999999999)";
+        REQUIRE_THROWS_AS(interpreter.Run(product, &output, {.max_nodes = 3}), LimitError);
+        interpreter.Run(product, &output, {.max_nodes = 4});
+        REQUIRE(output == "9999999999800000000001");
+    }
+}
+
+TEST_CASE("Limit errors are reported per expression and never cached") {
+    Interpreter interpreter({.cache_bytes = 1 << 20, .limits = {.max_steps = 50}});
+    std::string deep = MakeNested(100);
+    REQUIRE_THROWS_AS(interpreter.Run(deep), LimitError);
+    REQUIRE(interpreter.Run("(+ 1 2)") == "3");
+    std::string output;
+    interpreter.Run(deep, &output, {});
+    REQUIRE(output == "100");
+    REQUIRE(interpreter.GetCacheStats().entries == 2);
+
+    // Not the expression cached above, a hit would not be evaluated.
+    std::string input = "(+ 1 2) " + MakeNested(200) + " (car '(a))";
+    StringSource source(input);
+    std::vector<BatchResult> results;
+    interpreter.RunStream(&source, [&](const BatchResult& result) { results.push_back(result); });
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[0].output == "3");
+    REQUIRE(results[1].status == Status::kLimitError);
+    REQUIRE(results[2].output == "a");
+
+    std::vector<std::string> exprs = {"(+ 1 2)", deep};
+    auto batch = interpreter.RunBatch(exprs);
+    REQUIRE(batch[0].output == "3");
+    REQUIRE(batch[1].status == Status::kLimitError);
+}
+
+TEST_CASE("A cancelled stream reports every form and ends") {
+    CancellationToken token;
+    token.Cancel();
+    Interpreter interpreter({.limits = {.cancel = &token}});
+    StringSource source("(+ 1 2) (car '(a b)) 7");
+    std::vector<Status> statuses;
+    interpreter.RunStream(&source, [&](const BatchResult& result) {
+        statuses.push_back(result.status);
+    });
+    REQUIRE(statuses == std::vector<Status>(3, Status::kLimitError));
+}
@@ -0,0 +1,85 @@
+#include <catch.hpp>
+
+#include "applier.h"
+#include "scheme.h"
+
+static BatchResult RunCaptured(Interpreter* interpreter, const std::string& expr) {
+    try {
+        return {BatchResult::Status::kOk, interpreter->Run(expr)};
+    } catch (const SyntaxError& error) {
+        return {BatchResult::Status::kSyntaxError, error.what()};
+    } catch (const RuntimeError& error) {
+        return {BatchResult::Status::kRuntimeError, error.what()};
+    }
+}
+
+TEST_CASE("Builtins declare their arity and argument types") {
+    const Builtin* abs = Applier::Resolve("abs");
+    REQUIRE(abs->min_args == 1);
+    REQUIRE(abs->max_args == 1);
+    REQUIRE(abs->arg_type == ArgType::kNumber);
+
+    const Builtin* cons = Applier::Resolve("cons");
+    REQUIRE(cons->min_args == 2);
+    REQUIRE(cons->max_args == 2);
+    REQUIRE(cons->arg_type == ArgType::kAny);
+
+    const Builtin* divide = Applier::Resolve("/");
+    REQUIRE(divide->min_args == 2);
+    REQUIRE(divide->max_args == Builtin::kVariadic);
+    REQUIRE(divide->arg_type == ArgType::kNumber);
+
+    const Builtin* less = Applier::Resolve("<");
+    REQUIRE(less->kind == BuiltinKind::kCompare);
+    REQUIRE(less->comparator(1, 2));
+    REQUIRE(!less->comparator(2, 2));
+    REQUIRE(Applier::Resolve(">=")->comparator(2, 2));
+
+    REQUIRE(Applier::Resolve("list-ref")->arg_type == ArgType::kAny);
+}
+
+TEST_CASE("Both evaluators validate calls the same way") {
+    const char* exprs[] = {
+        "(abs)",
+        "(abs 1 2)",
+        "(abs #t)",
+        "(cons 1)",
+        "(car 1 2)",
+        "(+ 1 #f)",
+        "(+ 1 . 2)",
+        "(max 1 '(2))",
+        "(min)",
+        "(- 5)",
+        "(/ 8)",
+        "(/ 8 0)",
+        "(/ 100 5 2)",
+        "(< 1 #t)",
+        "(< #t)",
+        "(< 2 1 #t)",
+        "(< 1 2 . 3)",
+        "(= 1 1 1)",
+        "(>= 3 3 2 2)",
+        "(<)",
+        "(and 1 . 2)",
+        "(or #f 2 (car '()))",
+        "(and 1 #f (car '()))",
+        "(list-ref '(1 2) #t)",
+        "(list-tail '(1 2) 2)",
+        "(+ 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20)",
+        "(+ (car '()) #t)",
+        "(not 1)",
+        "(pair? '(1))",
+    };
+    Interpreter bytecode({.mode = EvalMode::kBytecode});
+    Interpreter tree({.mode = EvalMode::kTreeWalk});
+    for (const char* expr : exprs) {
+        INFO(expr);
+        BatchResult expected = RunCaptured(&bytecode, expr);
+        BatchResult actual = RunCaptured(&tree, expr);
+        REQUIRE(actual.status == expected.status);
+        REQUIRE(actual.output == expected.output);
+    }
+    REQUIRE(tree.Run("(+ 1 2 3 4 5 6 7 8 9 10 11 12 13 14 15 16 17 18 19 20)") == "210");
+    REQUIRE(tree.Run("(< 2 1 #t)") == "#f");
+    REQUIRE(tree.Run("(- 5)") == "5");
+}
@@ -0,0 +1,118 @@
+#include <catch.hpp>
+
+#include "applier.h"
+#include "scheme.h"
+#include "symbol_table.h"
+#include "vm.h"
+
+static AST MakeSymbol(const std::string& name) {
+    return Value::Unmanaged(SymbolTable::Intern(name));
+}
+
+static AST MakeList(std::initializer_list<AST> items) {
+    AST list;
+    for (auto it = std::rbegin(items); it != std::rend(items); ++it) {
+        list = MakeCell(*it, list);
+    }
+    return list;
+}
+
+// (+ 1 (+ 1 ... (+ 1 0))), built without the parser.
+static AST MakeNestedSum(size_t depth) {
+    AST ast = MakeNumber(0);
+    for (size_t i = 0; i < depth; ++i) {
+        ast = MakeList({MakeSymbol("+"), MakeNumber(1), ast});
+    }
+    return ast;
+}
+
+// ((car '(+)) 1 ((car '(+)) 1 ... 0)), every call is dispatched at runtime.
+static AST MakeNestedDynamicSum(size_t depth) {
+    AST operation = MakeList({MakeSymbol("car"), MakeQuote(MakeList({MakeSymbol("+")}))});
+    AST ast = MakeNumber(0);
+    for (size_t i = 0; i < depth; ++i) {
+        ast = MakeList({operation, MakeNumber(1), ast});
+    }
+    return ast;
+}
+
+TEST_CASE("Deep nesting is evaluated without native recursion") {
+    VirtualMachine vm;
+    REQUIRE(vm.Run(Compile(MakeNestedSum(50000))).GetNumber() == 50000);
+    REQUIRE(vm.Run(Compile(MakeNestedDynamicSum(20000))).GetNumber() == 20000);
+}
+
+TEST_CASE("Nesting past the maximum depth raises RuntimeError") {
+    REQUIRE(VirtualMachine(100).Run(Compile(MakeNestedSum(100), 100)).GetNumber() == 100);
+    REQUIRE_THROWS_AS(Compile(MakeNestedSum(101), 100), RuntimeError);
+
+    VirtualMachine vm(100);
+    REQUIRE(vm.Run(Compile(MakeNestedDynamicSum(100), 100)).GetNumber() == 100);
+    REQUIRE_THROWS_AS(vm.Run(Compile(MakeNestedDynamicSum(101), 100)), RuntimeError);
+    REQUIRE_THROWS_AS(vm.Run(Compile(MakeNestedSum(1000000))), RuntimeError);
+
+    Interpreter interpreter({.max_depth = 2});
+    REQUIRE(interpreter.Run("(+ 1 (+ 1 1))") == "3");
+    REQUIRE_THROWS_AS(interpreter.Run("(+ 1 (+ 1 (+ 1 1)))"), RuntimeError);
+    REQUIRE(interpreter.Run("(+ 1 1)") == "2");
+}
+
+TEST_CASE("The tree-walker evaluates deep nesting up to the maximum depth") {
+    REQUIRE(Applier::Apply(MakeNestedSum(50000)).GetNumber() == 50000);
+    REQUIRE(Applier::Apply(MakeNestedDynamicSum(20000)).GetNumber() == 20000);
+
+    REQUIRE(Applier::Apply(MakeNestedSum(100), 100).GetNumber() == 100);
+    REQUIRE_THROWS_AS(Applier::Apply(MakeNestedSum(101), 100), RuntimeError);
+    REQUIRE_THROWS_AS(Applier::Apply(MakeNestedSum(1000000)), RuntimeError);
+    REQUIRE(Applier::Apply(MakeNestedSum(10)).GetNumber() == 10);
+
+    Interpreter interpreter({.mode = EvalMode::kTreeWalk, .max_depth = 2});
+    REQUIRE(interpreter.Run("(+ 1 (+ 1 1))") == "3");
+    REQUIRE_THROWS_AS(interpreter.Run("(+ 1 (+ 1 (+ 1 1)))"), RuntimeError);
+    REQUIRE(interpreter.Run("(+ 1 1)") == "2");
+}
+
+TEST_CASE("Long and deep lists are destroyed without recursion") {
+    AST list;
+    for (size_t i = 0; i < 1000000; ++i) {
+        list = MakeCell(MakeNumber(i), list);
+    }
+    list = nullptr;
+
+    AST nested = MakeNestedSum(1000000);
+    nested = nullptr;
+    REQUIRE(nested == nullptr);
+}
+
+static std::string Repeat(const std::string& text, size_t count) {
+    std::string output;
+    for (size_t i = 0; i < count; ++i) {
+        output += text;
+    }
+    return output;
+}
+
+TEST_CASE("Deeply nested input is parsed and printed without native recursion") {
+    Interpreter interpreter;
+    REQUIRE(interpreter.Run(Repeat("(+ 1 ", 50000) + "0" + Repeat(")", 50000)) == "50000");
+
+    std::string quotes = Repeat("'", 50000) + "1";
+    REQUIRE(interpreter.Run(quotes) == Repeat("(quote ", 49999) + "1" + Repeat(")", 49999));
+
+    std::string nested_list = "'" + Repeat("(", 50000) + Repeat(")", 50000);
+    REQUIRE(interpreter.Run(nested_list) == Repeat("(", 49999) + "()" + Repeat(")", 49999));
+
+    std::string dotted = "'" + Repeat("(1 . ", 50000) + "2" + Repeat(")", 50000);
+    REQUIRE(interpreter.Run(dotted) == "(" + Repeat("1 ", 49999) + "1 . 2)");
+}
+
+TEST_CASE("Input nested past the read limit raises SyntaxError") {
+    Interpreter interpreter({.max_read_depth = 3});
+    REQUIRE(interpreter.Run("'(1 (2))") == "(1 (2))");
+    REQUIRE_THROWS_AS(interpreter.Run("'(1 ((2)))"), SyntaxError);
+    REQUIRE_THROWS_AS(interpreter.Run("'(1 (quote (2)))"), SyntaxError);
+    REQUIRE_THROWS_AS(interpreter.Run("''''1"), SyntaxError);
+    REQUIRE(interpreter.Run("'''1") == "(quote (quote 1))");
+
+    REQUIRE_THROWS_AS(Interpreter().Run(Repeat("(", 200000)), SyntaxError);
+}
@@ -0,0 +1,90 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+
+#include <random>
+#include <string>
+#include <vector>
+
+using Status = BatchResult::Status;
+
+static BatchResult RunCaptured(Interpreter* interpreter, const std::string& expr) {
+    try {
+        return {Status::kOk, interpreter->Run(expr)};
+    } catch (const SyntaxError& error) {
+        return {Status::kSyntaxError, error.what()};
+    } catch (const LimitError& error) {
+        return {Status::kLimitError, error.what()};
+    } catch (const RuntimeError& error) {
+        return {Status::kRuntimeError, error.what()};
+    } catch (const NameError& error) {
+        return {Status::kNameError, error.what()};
+    }
+}
+
+// The bytecode VM must agree with the tree-walker on every expression: the
+// same printed result, or an error of the same class with the same message.
+static void RequireSameOutcome(const std::vector<std::string>& exprs) {
+    Interpreter bytecode({.mode = EvalMode::kBytecode});
+    Interpreter tree({.mode = EvalMode::kTreeWalk});
+    for (const auto& expr : exprs) {
+        INFO(expr);
+        BatchResult expected = RunCaptured(&tree, expr);
+        BatchResult actual = RunCaptured(&bytecode, expr);
+        REQUIRE(actual.status == expected.status);
+        REQUIRE(actual.output == expected.output);
+    }
+}
+
+TEST_CASE("Both evaluators agree on a fixed corpus") {
+    RequireSameOutcome({
+        "1", "-1", "#t", "#f", "'()", "'x", "''x", "'(1 . 2)", "x", "()", "(quote)",
+        "(+)", "(+ 1 2 3)", "(- 5)", "(- 5 1 1)", "(* 2 3 4)", "(/ 12 2 3)", "(/ 1 0)", "(/ 7)",
+        "(max 1 5 3)", "(min 4 -2)", "(max)", "(abs -7)", "(abs 1 2)", "(+ 1 #t)", "(+ 1 '(1))",
+        "(* 4611686018427387903 4611686018427387903)", "(- -4611686018427387904 1)",
+        "(= 1 1 1)", "(= 1 2 (car '()))", "(< 1 2 3)", "(< 3 2 (car '()))", "(>= 3 3 1)",
+        "(<= 1 #t)", "(> 1)", "(<)", "(< 1 . 2)", "(< #t 1)",
+        "(and)", "(or)", "(and 1 2)", "(and 1 #f (car '()))", "(or #f 3)", "(or #f . 2)",
+        "(and 1 . 2)", "(or (car '()) 1)",
+        "(not #f)", "(not 1)", "(number? 'x)", "(boolean? #f)", "(null? '())", "(pair? '(1))",
+        "(list? '(1 . 2))", "(list? '(1 2))",
+        "(car '(1 2))", "(cdr '(1 2))", "(car '())", "(cdr 1)", "(cons 1 2)", "(cons 1 '(2))",
+        "(list)", "(list 1 (+ 1 1))", "(list-ref '(1 2 3) 1)", "(list-ref '(1 2) 5)",
+        "(list-tail '(1 2 3) 2)", "(list-tail '(1 2) 3)", "(list-ref '(1 2) -1)",
+        "((car '(+)) 1 2)", "((car '(and)) 1 #f)", "((car '(list)) 1 2)", "((car '(1)) 2)",
+        "((quote +) 1 2)", "('+ 1 2)", "(1 2)", "(#t)", "(foo 1)", "(+ 1 (foo))",
+        "(+ 1 . 2)", "(car '(1) '(2))", "(cons 1)",
+    });
+}
+
+TEST_CASE("Both evaluators agree on random expressions") {
+    static const std::vector<std::string> kOperators = {
+        "+", "-", "*", "/", "max", "min", "abs", "=", "<", ">", "<=", ">=", "not", "and", "or",
+        "number?", "boolean?", "null?", "pair?", "list?", "car", "cdr", "cons", "list",
+        "list-ref", "list-tail", "(car '(+ and))", "(car '(1))", "foo"};
+    static const std::vector<std::string> kAtoms = {
+        "0", "1", "2", "-3", "4611686018427387903", "-99999999999999999999", "#t", "#f", "'()",
+        "'(1 2 3)", "'(1 . 2)", "'x", "'#f", "''1", "x"};
+
+    std::mt19937 gen(20261017);
+    auto generate = [&](auto&& self, int depth) -> std::string {
+        if (depth == 0 || gen() % 4 == 0) {
+            return kAtoms[gen() % kAtoms.size()];
+        }
+        std::string expr = "(" + kOperators[gen() % kOperators.size()];
+        for (size_t i = gen() % 4; i > 0; --i) {
+            expr += " " + self(self, depth - 1);
+        }
+        // An improper operand list now and then.
+        if (gen() % 16 == 0) {
+            expr += " . " + kAtoms[gen() % kAtoms.size()];
+        }
+        return expr + ")";
+    };
+
+    std::vector<std::string> exprs;
+    for (int i = 0; i < 5000; ++i) {
+        exprs.push_back(generate(generate, 5));
+    }
+    RequireSameOutcome(exprs);
+}
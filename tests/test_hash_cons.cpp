@@ -0,0 +1,113 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+#include "parser.h"
+#include "arena.h"
+#include "cons_table.h"
+
+#include <atomic>
+#include <thread>
+
+static AST Parse(std::string_view text) {
+    Tokenizer tokenizer{text};
+    return Read(&tokenizer);
+}
+
+static const Value& Nth(const Value& list, size_t index) {
+    const Value* it = &list;
+    for (size_t i = 0; i < index; ++i) {
+        it = &As<Cell>(*it)->GetSecond();
+    }
+    return As<Cell>(*it)->GetFirst();
+}
+
+TEST_CASE("Identical subtrees share one node") {
+    HashConsScope scope;
+    AST ast = Parse("((1 (a b) 9000000000000000000) (1 (a b) 9000000000000000000) '(x) '(x))");
+    REQUIRE(Nth(ast, 0) == Nth(ast, 1));
+    REQUIRE(Nth(ast, 2) == Nth(ast, 3));
+    REQUIRE(Nth(Nth(ast, 0), 2) == Nth(Nth(ast, 1), 2));
+    REQUIRE(Parse("(1 (a b) 9000000000000000000)") == Nth(ast, 0));
+    REQUIRE(AsString(ast) ==
+            "((1 (a b) 9000000000000000000) (1 (a b) 9000000000000000000) "
+            "(quote (x)) (quote (x)))");
+}
+
+TEST_CASE("IsEqual agrees with and without hash-consing") {
+    const char* texts[] = {"(1 (a b) 9000000000000000000)",
+                           "(1 (a b) 9000000000000000001)",
+                           "(1 (a c))",
+                           "(1 (a b) . 2)",
+                           "'(x)",
+                           "()",
+                           "#t",
+                           "-5"};
+    for (const char* lhs : texts) {
+        for (const char* rhs : texts) {
+            bool expected = std::string_view(lhs) == rhs;
+            REQUIRE(IsEqual(Parse(lhs), Parse(rhs)) == expected);
+            HashConsScope scope;
+            AST a = Parse(lhs);
+            AST b = Parse(rhs);
+            REQUIRE(IsEqual(a, b) == expected);
+            REQUIRE((a == b) == expected);
+            HashConsScope off(false);
+            REQUIRE(IsEqual(a, Parse(rhs)) == expected);
+        }
+    }
+}
+
+TEST_CASE("Dead nodes leave the table") {
+    size_t before = ConsTable::GetSize();
+    {
+        HashConsScope scope;
+        AST ast = Parse("((1 2) (1 2) '(1 2) -9000000000000000000)");
+        // (1 2) and its tail, the quote, the boxed number and the four outer cells.
+        REQUIRE(ConsTable::GetSize() == before + 8);
+    }
+    REQUIRE(ConsTable::GetSize() == before);
+}
+
+TEST_CASE("The arena takes precedence over hash-consing") {
+    Arena arena;
+    ArenaScope arena_scope(&arena);
+    HashConsScope scope;
+    AST ast = Parse("((1 2) (1 2))");
+    REQUIRE(Nth(ast, 0) != Nth(ast, 1));
+    REQUIRE(IsEqual(Nth(ast, 0), Nth(ast, 1)));
+    REQUIRE(!ConsTable::IsCanonical(ast));
+}
+
+TEST_CASE("Run with hash_cons matches the default interpreter") {
+    const char* exprs[] = {"(cons '(1 2) '(1 2))", "(list-ref '((a) (a) (b)) 1)",
+                           "(cdr '(1 9000000000000000000 9000000000000000000))",
+                           "(cons (quote (1)) (quote (1)))"};
+    Interpreter plain;
+    for (auto mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode, .hash_cons = true});
+        for (const char* expr : exprs) {
+            REQUIRE(interpreter.Run(expr) == plain.Run(expr));
+        }
+    }
+}
+
+TEST_CASE("Threads share the table safely") {
+    std::atomic<bool> shared = true;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t) {
+        threads.emplace_back([&shared] {
+            HashConsScope scope;
+            for (int i = 0; i < 2000; ++i) {
+                AST a = Parse("((1 2 3) (4 5 6) " + std::to_string(i % 7) + ")");
+                AST b = Parse("((1 2 3) (4 5 6) " + std::to_string(i % 7) + ")");
+                if (a != b) {
+                    shared = false;
+                }
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(shared);
+}
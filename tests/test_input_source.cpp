@@ -0,0 +1,123 @@
+#include <catch.hpp>
+
+#include "error.h"
+#include "scheme.h"
+#include "tokenizer.h"
+
+#include <cstdio>
+#include <sstream>
+
+#include <unistd.h>
+
+static const std::string kProgram = "(list-ref '(123 #t #f foo-bar? (a . b)) -45 +6 - +)\n";
+
+static const std::vector<Token> kTokens = {
+    BracketToken::OPEN,     SymbolToken{"list-ref"}, QuoteToken{},       BracketToken::OPEN,
+    ConstantToken{123},     BooleanToken{true},      BooleanToken{false}, SymbolToken{"foo-bar?"},
+    BracketToken::OPEN,     SymbolToken{"a"},        DotToken{},          SymbolToken{"b"},
+    BracketToken::CLOSE,    BracketToken::CLOSE,     ConstantToken{-45},  ConstantToken{6},
+    SymbolToken{"-"},       SymbolToken{"+"},        BracketToken::CLOSE};
+
+// Compares every token before advancing, names may not outlive Next().
+static void RequireTokens(Tokenizer* tokenizer) {
+    for (const auto& expected : kTokens) {
+        REQUIRE(!tokenizer->IsEnd());
+        REQUIRE(tokenizer->GetToken() == expected);
+        tokenizer->Next();
+    }
+    REQUIRE(tokenizer->IsEnd());
+}
+
+TEST_CASE("Every input source yields the same tokens") {
+    SECTION("string_view") {
+        Tokenizer tokenizer{std::string_view(kProgram)};
+        RequireTokens(&tokenizer);
+    }
+    SECTION("istream, one character per chunk") {
+        std::stringstream ss{kProgram};
+        StreamSource source(&ss, 1);
+        Tokenizer tokenizer{&source};
+        RequireTokens(&tokenizer);
+    }
+    SECTION("file descriptor and mapped file") {
+        char path[] = "/tmp/scheme_test_input_XXXXXX";
+        int fd = mkstemp(path);
+        REQUIRE(fd >= 0);
+        REQUIRE(write(fd, kProgram.data(), kProgram.size()) == ssize_t(kProgram.size()));
+        for (size_t block_size : {1, 3, 4096}) {
+            lseek(fd, 0, SEEK_SET);
+            FdSource source(fd, block_size);
+            Tokenizer tokenizer{&source};
+            RequireTokens(&tokenizer);
+        }
+        {
+            MappedFileSource source(path);
+            Tokenizer tokenizer{&source};
+            RequireTokens(&tokenizer);
+        }
+        close(fd);
+        unlink(path);
+    }
+}
+
+TEST_CASE("Symbols from in-memory input point into it") {
+    std::string input = "(foo bar)";
+    Tokenizer tokenizer{std::string_view{input}};
+    tokenizer.Next();
+    Token foo = tokenizer.GetToken();
+    REQUIRE(std::string_view{std::get<SymbolToken>(foo).name}.data() == input.data() + 1);
+    tokenizer.Next();
+    REQUIRE(foo == Token{SymbolToken{"foo"}});
+    REQUIRE(tokenizer.GetToken() == Token{SymbolToken{"bar"}});
+}
+
+TEST_CASE("Read returns tokens that outlive the input") {
+    auto tokens = Read(std::string("(foo bar 99999999999999999999)"));
+    REQUIRE(tokens.size() == 5);
+    REQUIRE(std::get<SymbolToken>(tokens[1]).name == "foo");
+    REQUIRE(std::get<SymbolToken>(tokens[2]).name == "bar");
+    REQUIRE(std::get<ConstantToken>(tokens[3]).big == "99999999999999999999");
+}
+
+TEST_CASE("Tokens from a stream outlive the next token") {
+    std::istringstream stream("abc def 99999999999999999999 1");
+    Tokenizer tokenizer(&stream);
+    Token first = tokenizer.GetToken();
+    tokenizer.Next();
+    REQUIRE(first == Token{SymbolToken{"abc"}});
+    REQUIRE(tokenizer.GetToken() == Token{SymbolToken{"def"}});
+    tokenizer.Next();
+    Token big = tokenizer.GetToken();
+    tokenizer.Next();
+    REQUIRE(big == Token{ConstantToken{0, "99999999999999999999"}});
+    REQUIRE(tokenizer.GetToken() == Token{ConstantToken{1}});
+}
+
+TEST_CASE("Integers use the full int64_t range") {
+    REQUIRE(Read("9223372036854775807") == std::vector<Token>{ConstantToken{INT64_MAX}});
+    REQUIRE(Read("-9223372036854775808") == std::vector<Token>{ConstantToken{INT64_MIN}});
+    REQUIRE(Read("3000000000") == std::vector<Token>{ConstantToken{3000000000}});
+}
+
+TEST_CASE("Integers outside int64_t become big constants") {
+    REQUIRE(Read("(9223372036854775808 -9223372036854775809)") ==
+            std::vector<Token>{BracketToken::OPEN, ConstantToken{0, "9223372036854775808"},
+                               ConstantToken{0, "-9223372036854775809"}, BracketToken::CLOSE});
+
+    // Split across chunks, the literal is assembled in the tokenizer.
+    std::istringstream stream("123456789012345678901234567890 -123456789012345678901234567890");
+    StreamSource source(&stream, 7);
+    Tokenizer tokenizer(&source);
+    REQUIRE(std::get<ConstantToken>(tokenizer.GetToken()).big == "123456789012345678901234567890");
+    tokenizer.Next();
+    REQUIRE(std::get<ConstantToken>(tokenizer.GetToken()).big ==
+            "-123456789012345678901234567890");
+}
+
+TEST_CASE("Run accepts a view that is not null-terminated") {
+    Interpreter interpreter;
+    std::string_view input = "(+ 1 2)(+ 3 4)";
+    REQUIRE(interpreter.Run(input.substr(0, 7)) == "3");
+    REQUIRE(interpreter.Run(std::string("(* 6 7)")) == "42");
+    REQUIRE(interpreter.Run("(- 3000000000 1)") == "2999999999");
+}
@@ -0,0 +1,105 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+#include "parser.h"
+#include "arena.h"
+#include "cons_table.h"
+
+static AST Parse(std::string_view text) {
+    Tokenizer tokenizer{text};
+    return Read(&tokenizer);
+}
+
+// "(0 1 2 ... n-1)"
+static std::string MakeNumbers(size_t n) {
+    std::string text = "(";
+    for (size_t i = 0; i < n; ++i) {
+        text += std::to_string(i) + " ";
+    }
+    return text + ")";
+}
+
+TEST_CASE("Read lays a list out in one run") {
+    REQUIRE(sizeof(Cell) == 4 * sizeof(void*));
+
+    AST list = Parse("(a (b c) . d)");
+    const Cell* cell = As<Cell>(list);
+    REQUIRE(cell->GetRunLength() == 1);
+    REQUIRE(cell->GetRunCell(1) == As<Cell>(cell->GetSecond()));
+    REQUIRE(As<Cell>(cell->GetSecond())->GetRunLength() == 0);
+    REQUIRE(AsString(list) == "(a (b c) . d)");
+
+    size_t steps = 5;
+    REQUIRE(AsString(SkipCells(list, &steps)) == "d");
+    REQUIRE(steps == 3);
+    REQUIRE(!IsProperList(list));
+    REQUIRE(IsProperList(Parse("(a (b c) d)")));
+    REQUIRE(IsProperList(nullptr));
+}
+
+TEST_CASE("Lists longer than a run are chained runs") {
+    size_t length = Cell::kMaxRunLength + 1000;
+    std::string text = MakeNumbers(length);
+    AST list = Parse(text);
+    REQUIRE(As<Cell>(list)->GetRunLength() == 999);
+    REQUIRE(AsString(list) == text.substr(0, text.size() - 2) + ")");
+
+    for (size_t index : {size_t{0}, size_t{999}, size_t{1000}, length - 1}) {
+        size_t steps = index;
+        const AST& rest = SkipCells(list, &steps);
+        REQUIRE(steps == 0);
+        REQUIRE(As<Cell>(rest)->GetFirst().GetNumber() == static_cast<int64_t>(index));
+    }
+    size_t steps = length + 5;
+    REQUIRE(SkipCells(list, &steps) == nullptr);
+    REQUIRE(steps == 5);
+}
+
+TEST_CASE("A tail keeps the rest of its run alive") {
+    AST tail;
+    {
+        AST list = Parse("(1 2 3 4 5)");
+        size_t steps = 3;
+        tail = SkipCells(list, &steps);
+    }
+    REQUIRE(AsString(tail) == "(4 5)");
+    REQUIRE(As<Cell>(tail)->GetRunLength() == 1);
+    AST pair = MakeCell(MakeNumber(0), tail);
+    tail = nullptr;
+    REQUIRE(AsString(pair) == "(0 4 5)");
+}
+
+TEST_CASE("list-ref, list-tail and list? jump over runs") {
+    std::string numbers = MakeNumbers(100000);
+    for (auto mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode});
+        REQUIRE(interpreter.Run("(list-ref '" + numbers + " 99999)") == "99999");
+        REQUIRE(interpreter.Run("(list-ref '" + numbers + " 0)") == "0");
+        REQUIRE(interpreter.Run("(list-tail '" + numbers + " 99998)") == "(99998 99999)");
+        REQUIRE(interpreter.Run("(list-tail '" + numbers + " 100000)") == "()");
+        REQUIRE(interpreter.Run("(list? '" + numbers + ")") == "#t");
+        REQUIRE(interpreter.Run("(list-ref (list 1 2 3) 2)") == "3");
+        REQUIRE(interpreter.Run("(list-ref (cons 0 '(1 2)) 2)") == "2");
+        REQUIRE(interpreter.Run("(list? '(1 2 . 3))") == "#f");
+        REQUIRE(interpreter.Run("(list? (cons 1 '(2 3)))") == "#t");
+        REQUIRE_THROWS_AS(interpreter.Run("(list-ref '" + numbers + " 100000)"), RuntimeError);
+        REQUIRE_THROWS_AS(interpreter.Run("(list-tail '(1 2) 3)"), RuntimeError);
+        REQUIRE_THROWS_AS(interpreter.Run("(list-ref '(1 2 . 3) 0)"), RuntimeError);
+    }
+}
+
+TEST_CASE("Runs fit the arena blocks") {
+    Arena arena(1024);
+    ArenaScope scope(&arena);
+    AST list = Parse(MakeNumbers(1000));
+    REQUIRE(As<Cell>(list)->GetRunLength() < 1024 / sizeof(Cell));
+    size_t steps = 777;
+    REQUIRE(As<Cell>(SkipCells(list, &steps))->GetFirst().GetNumber() == 777);
+}
+
+TEST_CASE("Hash-consed lists are plain cells") {
+    HashConsScope scope;
+    AST list = Parse("(1 2 3)");
+    REQUIRE(As<Cell>(list)->GetRunLength() == 0);
+    REQUIRE(ConsTable::IsCanonical(list));
+}
@@ -0,0 +1,98 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+
+#include <string>
+#include <vector>
+
+using Status = BatchResult::Status;
+
+// '(0 1 ... n-1): one run of n cells and a quote, all made by Read.
+static std::string MakeQuotedList(size_t length) {
+    std::string list = "'(";
+    for (size_t i = 0; i < length; ++i) {
+        list += std::to_string(i) + " ";
+    }
+    return list + ")";
+}
+
+TEST_CASE("Memory is not accounted by default") {
+    Interpreter interpreter;
+    REQUIRE(interpreter.Run(MakeQuotedList(100)).starts_with("(0 1"));
+    REQUIRE(interpreter.GetMemoryStats().total_bytes == 0);
+    REQUIRE(interpreter.GetMemoryStats().peak_bytes == 0);
+}
+
+TEST_CASE("Every object of a run is accounted for") {
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode, .account_memory = true});
+        interpreter.Run("1");
+        REQUIRE(interpreter.GetMemoryStats().total_bytes == 0);
+
+        interpreter.Run(MakeQuotedList(100));
+        size_t read_bytes = interpreter.GetMemoryStats().total_bytes;
+        REQUIRE(read_bytes >= 100 * sizeof(Cell) + sizeof(Quote));
+        REQUIRE(interpreter.GetMemoryStats().peak_bytes == read_bytes);
+
+        // A boxed number more than the small one.
+        interpreter.Run("(* 3 3)");
+        size_t small = interpreter.GetMemoryStats().total_bytes;
+        interpreter.Run("(* 99999999999 99999999999)");
+        REQUIRE(interpreter.GetMemoryStats().total_bytes > small);
+    }
+}
+
+TEST_CASE("The peak only counts what is alive at once") {
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode, .account_memory = true});
+        // Each product is dropped by the addition that consumes it.
+        std::string expr = "(+ 0";
+        for (int i = 0; i < 20; ++i) {
+            expr += " (- (* 99999999999 99999999999) 9999999999800000000000)";
+        }
+        expr += ")";
+        REQUIRE(interpreter.Run(expr) == "20");
+        const MemoryStats& stats = interpreter.GetMemoryStats();
+        REQUIRE(stats.peak_bytes < stats.total_bytes);
+
+        // Nothing is freed before the arena is dropped.
+        Interpreter arena({.mode = mode, .use_arena = true, .account_memory = true});
+        REQUIRE(arena.Run(expr) == "20");
+        REQUIRE(arena.GetMemoryStats().peak_bytes == arena.GetMemoryStats().total_bytes);
+        REQUIRE(arena.GetMemoryStats().total_bytes == stats.total_bytes);
+    }
+}
+
+TEST_CASE("max_bytes stops a run before it allocates past the cap") {
+    for (bool use_arena : {false, true}) {
+        Interpreter interpreter({.use_arena = use_arena, .account_memory = true});
+        std::string list = MakeQuotedList(1000);
+        interpreter.Run(list);
+        size_t needed = interpreter.GetMemoryStats().peak_bytes;
+
+        std::string output = "kept";
+        REQUIRE_THROWS_WITH(interpreter.Run(list, &output, {.max_bytes = needed - 1}),
+                            "Limit error: memory limit exceeded");
+        REQUIRE(output == "kept");
+        REQUIRE(interpreter.GetMemoryStats().peak_bytes < needed);
+        interpreter.Run(list, &output, {.max_bytes = needed});
+        REQUIRE(output.starts_with("(0 1 2"));
+
+        // Callers that only tell syntax from runtime errors see a runtime one.
+        REQUIRE_THROWS_AS(interpreter.Run(list, &output, {.max_bytes = 64}), RuntimeError);
+    }
+}
+
+TEST_CASE("The memory cap is reported per expression") {
+    Interpreter interpreter({.limits = {.max_bytes = 4096}});
+    std::string input = "(+ 1 2) " + MakeQuotedList(1000) + " (car '(a))";
+    StringSource source(input);
+    std::vector<BatchResult> results;
+    interpreter.RunStream(&source, [&](const BatchResult& result) { results.push_back(result); });
+    REQUIRE(results.size() == 3);
+    REQUIRE(results[0].output == "3");
+    REQUIRE(results[1].status == Status::kLimitError);
+    REQUIRE(results[2].output == "a");
+    REQUIRE(interpreter.GetMemoryStats().total_bytes > 0);
+    REQUIRE(interpreter.GetMemoryStats().peak_bytes <= 4096);
+}
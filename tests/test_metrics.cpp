@@ -0,0 +1,135 @@
+#include <catch.hpp>
+
+#include "applier.h"
+#include "scheme.h"
+
+#include <vector>
+
+using Status = BatchResult::Status;
+
+static const BuiltinMetrics& GetBuiltinMetrics(const Metrics& metrics, const std::string& name) {
+    return metrics.GetBuiltinMetrics(GetBuiltinId(Applier::Resolve(name)));
+}
+
+static uint64_t GetCalls(const Metrics& metrics, const std::string& name) {
+    return GetBuiltinMetrics(metrics, name).calls;
+}
+
+TEST_CASE("LatencyHistogram buckets by powers of four") {
+    LatencyHistogram histogram;
+    const uint64_t kSamples[] = {0, 1000, 1001, 4000, 4001, uint64_t{1} << 40};
+    for (uint64_t ns : kSamples) {
+        histogram.Record(ns);
+    }
+    REQUIRE(histogram.GetBucket(0) == 2);
+    REQUIRE(histogram.GetBucket(1) == 2);
+    REQUIRE(histogram.GetBucket(2) == 1);
+    REQUIRE(histogram.GetBucket(LatencyHistogram::kBounds) == 1);
+    REQUIRE(histogram.GetCount() == 6);
+    REQUIRE(histogram.GetSumNs() == 10002 + (uint64_t{1} << 40));
+}
+
+TEST_CASE("Both evaluators count builtin calls") {
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode, .metrics = true});
+        REQUIRE(interpreter.Run("(+ 1 (* 2 3) (* 4 5))") == "27");
+        REQUIRE(interpreter.Run("(car (cdr '(1 2)))") == "2");
+        // No kernel runs, each call is counted once however many operands it takes.
+        REQUIRE(interpreter.Run("(and (< 1 2 3) (list 1))") == "(1)");
+        REQUIRE(interpreter.Run("(or (> 1 2) (= 1 1) (<= 1 (* 1 1)))") == "#t");
+        // Known only at runtime.
+        REQUIRE(interpreter.Run("((car '(or)) #f 1)") == "1");
+
+        Metrics metrics = interpreter.GetMetrics();
+        REQUIRE(GetCalls(metrics, "+") == 1);
+        REQUIRE(GetCalls(metrics, "*") == 2);
+        REQUIRE(GetCalls(metrics, "car") == 2);
+        REQUIRE(GetCalls(metrics, "cdr") == 1);
+        REQUIRE(GetCalls(metrics, "-") == 0);
+        REQUIRE(GetCalls(metrics, "and") == 1);
+        REQUIRE(GetCalls(metrics, "<") == 1);
+        REQUIRE(GetCalls(metrics, "list") == 1);
+        REQUIRE(GetCalls(metrics, "or") == 2);
+        REQUIRE(GetCalls(metrics, ">") == 1);
+        REQUIRE(GetCalls(metrics, "=") == 1);
+        // Short-circuited, never reached.
+        REQUIRE(GetCalls(metrics, "<=") == 0);
+        REQUIRE(GetBuiltinMetrics(metrics, "and").nanoseconds == 0);
+        for (Stage stage : {Stage::kRead, Stage::kEvaluate, Stage::kPrint}) {
+            REQUIRE(metrics.GetStageLatency(stage).GetCount() == 5);
+        }
+    }
+}
+
+TEST_CASE("Metrics count errors by type") {
+    Interpreter interpreter({.cache_bytes = 1 << 20, .metrics = true});
+    REQUIRE_THROWS_AS(interpreter.Run("(1"), SyntaxError);
+    REQUIRE_THROWS_AS(interpreter.Run("(car '())"), RuntimeError);
+    // Answered from the cache, still reported.
+    REQUIRE_THROWS_AS(interpreter.Run("(car '())"), RuntimeError);
+    REQUIRE(interpreter.Run("(+ 1 2)") == "3");
+
+    StringSource source("(+ 1) (car 1) (cdr '(1)) )");
+    std::vector<Status> statuses;
+    interpreter.RunStream(&source, [&](const BatchResult& result) {
+        statuses.push_back(result.status);
+    });
+    REQUIRE(statuses.size() == 4);
+
+    Metrics metrics = interpreter.GetMetrics();
+    REQUIRE(metrics.GetErrorCount(Status::kSyntaxError) == 2);
+    REQUIRE(metrics.GetErrorCount(Status::kRuntimeError) == 3);
+    REQUIRE(metrics.GetErrorCount(Status::kNameError) == 0);
+    REQUIRE(metrics.GetErrorCount(Status::kOk) == 0);
+    // The cache hit skipped evaluation.
+    REQUIRE(metrics.GetStageLatency(Stage::kEvaluate).GetCount() == 5);
+}
+
+TEST_CASE("Batch metrics add up every worker") {
+    Interpreter interpreter({.batch_threads = 4, .metrics = true});
+    std::vector<std::string> exprs(100, "(+ 1 2)");
+    exprs.push_back("(car 1)");
+    interpreter.RunBatch(exprs);
+    Metrics metrics = interpreter.GetMetrics();
+    REQUIRE(GetCalls(metrics, "+") == 100);
+    REQUIRE(metrics.GetErrorCount(Status::kRuntimeError) == 1);
+    REQUIRE(metrics.GetStageLatency(Stage::kRead).GetCount() == 101);
+}
+
+TEST_CASE("Disabled metrics stay zero") {
+    Interpreter interpreter;
+    interpreter.Run("(+ 1 2)");
+    REQUIRE_THROWS(interpreter.Run("(car 1)"));
+    Metrics metrics = interpreter.GetMetrics();
+    REQUIRE(GetCalls(metrics, "+") == 0);
+    REQUIRE(metrics.GetStageLatency(Stage::kRead).GetCount() == 0);
+    REQUIRE(metrics.GetErrorCount(Status::kRuntimeError) == 0);
+    REQUIRE(Metrics::Current() == nullptr);
+}
+
+TEST_CASE("FormatPrometheus exports every family") {
+    Interpreter interpreter({.metrics = true});
+    interpreter.Run("(list-ref '(1 2) (+ 0 1))");
+    interpreter.Run("(or (< 1 2) #f)");
+    REQUIRE_THROWS(interpreter.Run(")"));
+    std::string text = FormatPrometheus(interpreter.GetMetrics());
+
+    REQUIRE(text.find("# TYPE scheme_builtin_calls_total counter\n") != std::string::npos);
+    REQUIRE(text.find("scheme_builtin_calls_total{builtin=\"list-ref\"} 1\n") != std::string::npos);
+    REQUIRE(text.find("scheme_builtin_calls_total{builtin=\"+\"} 1\n") != std::string::npos);
+    REQUIRE(text.find("scheme_builtin_calls_total{builtin=\"abs\"} 0\n") != std::string::npos);
+    REQUIRE(text.find("scheme_builtin_calls_total{builtin=\"or\"} 1\n") != std::string::npos);
+    REQUIRE(text.find("scheme_builtin_calls_total{builtin=\"<\"} 1\n") != std::string::npos);
+    REQUIRE(text.find("scheme_builtin_calls_total{builtin=\"and\"} 0\n") != std::string::npos);
+    REQUIRE(text.find("scheme_builtin_seconds_total{builtin=\"or\"} 0\n") != std::string::npos);
+    REQUIRE(text.find("scheme_builtin_seconds_total{builtin=\"+\"} ") != std::string::npos);
+    REQUIRE(text.find("# TYPE scheme_stage_seconds histogram\n") != std::string::npos);
+    REQUIRE(text.find("scheme_stage_seconds_bucket{stage=\"read\",le=\"+Inf\"} 3\n") !=
+            std::string::npos);
+    REQUIRE(text.find("scheme_stage_seconds_bucket{stage=\"print\",le=\"1e-06\"} ") !=
+            std::string::npos);
+    REQUIRE(text.find("scheme_stage_seconds_count{stage=\"evaluate\"} 2\n") != std::string::npos);
+    REQUIRE(text.find("scheme_errors_total{type=\"syntax\"} 1\n") != std::string::npos);
+    REQUIRE(text.find("scheme_errors_total{type=\"runtime\"} 0\n") != std::string::npos);
+    REQUIRE(text.ends_with("\n"));
+}
@@ -0,0 +1,166 @@
+#include <catch.hpp>
+
+#include "applier.h"
+#include "budget.h"
+#include "optimizer.h"
+#include "scheme.h"
+
+#include <random>
+
+static AST Parse(const std::string& expr) {
+    Tokenizer tokenizer{std::string_view(expr)};
+    return Read(&tokenizer);
+}
+
+static std::string Optimized(const std::string& expr, size_t* folds = nullptr) {
+    return AsString(Optimize(
+        Parse(expr),
+        [&](const AST& call) {
+            if (folds) {
+                ++*folds;
+            }
+            return Applier::Apply(call);
+        },
+        kDefaultMaxDepth));
+}
+
+static BatchResult RunCaptured(Interpreter* interpreter, const std::string& expr) {
+    try {
+        return {BatchResult::Status::kOk, interpreter->Run(expr)};
+    } catch (const SyntaxError& error) {
+        return {BatchResult::Status::kSyntaxError, error.what()};
+    } catch (const RuntimeError& error) {
+        return {BatchResult::Status::kRuntimeError, error.what()};
+    }
+}
+
+static void RequireSameOutcome(const std::vector<std::string>& exprs) {
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter plain({.mode = mode});
+        Interpreter optimized({.mode = mode, .optimize = true});
+        for (const auto& expr : exprs) {
+            INFO(expr);
+            BatchResult expected = RunCaptured(&plain, expr);
+            BatchResult actual = RunCaptured(&optimized, expr);
+            REQUIRE(actual.status == expected.status);
+            REQUIRE(actual.output == expected.output);
+        }
+    }
+}
+
+TEST_CASE("Calls on literals are folded") {
+    REQUIRE(Optimized("(+ 1 (* 2 3))") == "7");
+    REQUIRE(Optimized("(< 1 2 (abs -3))") == "#t");
+    REQUIRE(Optimized("(cdr '(1 2))") == "(quote (2))");
+    REQUIRE(Optimized("(list 1 (+ 2 3))") == "(quote (1 (+ 2 3)))");
+    REQUIRE(Optimized("(car '(a b))") == "(quote a)");
+    REQUIRE(Optimized("'(+ 1 2)") == "(quote (+ 1 2))");
+    REQUIRE(Optimized("((car '(+)) (+ 1 2))") == "((quote +) (+ 1 2))");
+}
+
+TEST_CASE("Calls that raise are kept") {
+    REQUIRE(Optimized("(+ 1 (car '()))") == "(+ 1 (car (quote ())))");
+    REQUIRE(Optimized("(+ (* 2 3) '(1))") == "(+ 6 (quote (1)))");
+    REQUIRE(Optimized("(abs 1 2)") == "(abs 1 2)");
+    REQUIRE(Optimized("(foo (+ 1 2))") == "(foo (+ 1 2))");
+    REQUIRE(Optimized("(+ 1 . 2)") == "(+ 1 . 2)");
+    REQUIRE(Optimized("()") == "()");
+}
+
+TEST_CASE("Running out of budget while folding stops the run") {
+    size_t folds = 0;
+    {
+        Budget budget({.max_steps = 2});
+        BudgetScope scope(&budget);
+        REQUIRE_THROWS_AS(Optimized("(+ (* 2 3) (- 10 4))", &folds), LimitError);
+    }
+    REQUIRE(folds == 1);
+
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode, .optimize = true});
+        std::string output = "kept";
+        REQUIRE_THROWS_AS(interpreter.Run("(+ (* 2 3) (- 10 4))", &output, {.max_steps = 2}),
+                          LimitError);
+        REQUIRE(output == "kept");
+        REQUIRE(interpreter.Run("(+ (* 2 3) (- 10 4))") == "12");
+    }
+}
+
+TEST_CASE("Unreachable and/or arguments are pruned") {
+    REQUIRE(Optimized("(and #f (car '()))") == "#f");
+    REQUIRE(Optimized("(or 1 (car '()))") == "1");
+    REQUIRE(Optimized("(and 1 (car '()) 2 #f (car '()))") == "(and (car (quote ())) #f)");
+    REQUIRE(Optimized("(or #f (car '()) #f (cdr '()))") == "(or (car (quote ())) (cdr (quote ())))");
+    REQUIRE(Optimized("(and 1 (car '()))") == "(car (quote ()))");
+    REQUIRE(Optimized("(or (= 1 2) '#f)") == "(quote #f)");
+    REQUIRE(Optimized("(and)") == "#t");
+    REQUIRE(Optimized("(or)") == "#f");
+}
+
+TEST_CASE("Identical subexpressions are shared and folded once") {
+    size_t folds = 0;
+    REQUIRE(Optimized("(+ (* 2 3) (* 2 3) (* 2 3))", &folds) == "18");
+    REQUIRE(folds == 2);
+
+    AST ast = Optimize(
+        Parse("(+ (car '()) (car '()))"), [](const AST& call) { return Applier::Apply(call); },
+        kDefaultMaxDepth);
+    const AST& first = As<Cell>(As<Cell>(ast)->GetSecond())->GetFirst();
+    const AST& second = As<Cell>(As<Cell>(As<Cell>(ast)->GetSecond())->GetSecond())->GetFirst();
+    REQUIRE(first.GetWord() == second.GetWord());
+}
+
+TEST_CASE("Optimized evaluation keeps results and errors") {
+    RequireSameOutcome({
+        "(+ 1 2)", "(and 1 (car '()) 2)", "(or #f (car '()))", "(and #f (car '()))",
+        "(< 1 2 (car '()))", "(< 2 1 (car '()))", "(< -2000000000000000000)", "(= 1 '(1))",
+        "(list-ref '(1 2) 5)", "(list-tail '(1 2) (+ 1 1))", "((car '(+)) 1 2)",
+        "((car '(1)) 1 2)", "(1 2)", "(foo)", "(and 1 . 2)", "(or (car '()) . 2)",
+        "(list (car '()) 1)", "(cons (+ 1 2) (list 3))", "(not (and 1 #f))", "(max)",
+        "(/ 1 0)", "(number? (cdr '(1)))", "(boolean? (or #f '#f))", "(null? (list))",
+    });
+}
+
+TEST_CASE("Random expressions behave the same optimized") {
+    static const std::vector<std::string> kOperators = {
+        "+", "-", "*", "/", "max", "min", "abs", "=", "<", ">=", "not", "and", "or",
+        "number?", "boolean?", "null?", "pair?", "list?", "car", "cdr", "cons", "list",
+        "list-ref", "list-tail"};
+    static const std::vector<std::string> kAtoms = {
+        "0", "1", "2", "-3", "#t", "#f", "'()", "'(1 2 3)", "'x", "'#f", "foo"};
+
+    std::mt19937 gen(20261016);
+    auto generate = [&](auto&& self, int depth) -> std::string {
+        if (depth == 0 || gen() % 4 == 0) {
+            return kAtoms[gen() % kAtoms.size()];
+        }
+        std::string expr = "(" + kOperators[gen() % kOperators.size()];
+        for (size_t i = gen() % 4; i > 0; --i) {
+            expr += " " + self(self, depth - 1);
+        }
+        return expr + ")";
+    };
+
+    std::vector<std::string> exprs;
+    for (int i = 0; i < 2000; ++i) {
+        exprs.push_back(generate(generate, 4));
+    }
+    RequireSameOutcome(exprs);
+}
+
+TEST_CASE("Depth limits still apply with the optimizer") {
+    std::string deep;
+    for (int i = 0; i < 20000; ++i) {
+        deep += "(+ 1 ";
+    }
+    deep += "0" + std::string(20000, ')');
+
+    Interpreter bytecode({.optimize = true});
+    REQUIRE(bytecode.Run(deep) == "20000");
+    Interpreter limited({.max_depth = 1000, .optimize = true});
+    REQUIRE_THROWS_AS(limited.Run(deep), RuntimeError);
+    Interpreter tree({.mode = EvalMode::kTreeWalk, .optimize = true});
+    REQUIRE(tree.Run(deep) == "20000");
+    Interpreter limited_tree({.mode = EvalMode::kTreeWalk, .max_depth = 1000, .optimize = true});
+    REQUIRE_THROWS_AS(limited_tree.Run(deep), RuntimeError);
+}
@@ -0,0 +1,179 @@
+#include <catch.hpp>
+
+#include "cons_table.h"
+#include "scheme.h"
+
+#include <thread>
+#include <vector>
+
+// The text `prepared` stands for with the given values written into its slots.
+static std::string Substitute(std::string text, const std::vector<std::string>& values) {
+    const char* kSlots[] = {"?a", "?b"};
+    for (size_t i = 0; i < values.size(); ++i) {
+        for (size_t at = text.find(kSlots[i]); at != std::string::npos;
+             at = text.find(kSlots[i], at + values[i].size())) {
+            text.replace(at, 2, values[i]);
+        }
+    }
+    return text;
+}
+
+static BatchResult Capture(const std::function<std::string()>& run) {
+    try {
+        return {BatchResult::Status::kOk, run()};
+    } catch (const SyntaxError& error) {
+        return {BatchResult::Status::kSyntaxError, error.what()};
+    } catch (const RuntimeError& error) {
+        return {BatchResult::Status::kRuntimeError, error.what()};
+    }
+}
+
+TEST_CASE("Slots are named in order of first appearance") {
+    Interpreter interpreter;
+    auto prepared = interpreter.Prepare("(max (+ ?b 3) ?a (car '(?b)) ?b)");
+    REQUIRE(prepared->GetSlotNames() == std::vector<std::string>{"b", "a"});
+    REQUIRE(prepared->GetSlotIndex("a") == 1);
+    REQUIRE_THROWS_AS(prepared->GetSlotIndex("c"), RuntimeError);
+    REQUIRE(interpreter.Execute(*prepared, {5, 100}) == "100");
+    REQUIRE(interpreter.Execute(*prepared, {500, 100}) == "503");
+
+    REQUIRE(interpreter.Prepare("(+ 1 2)")->GetSlotNames().empty());
+    REQUIRE_THROWS_AS(interpreter.Prepare("(+ 1 2) 3"), SyntaxError);
+    REQUIRE_THROWS_AS(interpreter.Prepare("(+ 1"), SyntaxError);
+}
+
+TEST_CASE("Executing is the same as running the substituted text") {
+    const std::string kTemplates[] = {
+        "(max (+ ?a 3) ?b)",
+        "(+ ?a ?a ?b)",
+        "(- (* ?a ?b) 1)",
+        "(list ?a ?b)",
+        "'(?a . ?b)",
+        "(quote (1 (?a) ?b))",
+        "(cons ?a '(?b))",
+        "(and (< ?a ?b) ?a)",
+        "(or (= ?a ?b) (> ?a ?b))",
+        "((car '(+ -)) ?a ?b)",
+        "((car '(list)) ?a ?b)",
+        "(?a 1 2)",
+        "(/ ?a ?b)",
+        "(number? ?a)",
+        "?a",
+    };
+    const std::vector<std::vector<std::string>> kValues = {
+        {"1", "2"},
+        {"-7", "7"},
+        {"0", "0"},
+        {"99999999999", "99999999999"},
+        {"123456789012345678901234567890", "-3"},
+        {"4611686018427387903", "1"},
+    };
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        for (bool use_arena : {false, true}) {
+            Interpreter interpreter({.mode = mode, .use_arena = use_arena});
+            for (const std::string& text : kTemplates) {
+                auto prepared = interpreter.Prepare(text);
+                size_t slots = text.find("?b") == std::string::npos ? 1 : 2;
+                REQUIRE(prepared->GetSlotNames().size() == slots);
+                for (const auto& values : kValues) {
+                    INFO(text << " " << values[0] << " " << values[1]);
+                    std::vector<AST> args;
+                    for (size_t i = 0; i < slots; ++i) {
+                        args.push_back(MakeNumber(BigInteger::FromDecimal(values[i])));
+                    }
+                    BatchResult expected =
+                        Capture([&] { return interpreter.Run(Substitute(text, values)); });
+                    BatchResult result = Capture([&] {
+                        std::string output;
+                        interpreter.Execute(*prepared, args, &output);
+                        return output;
+                    });
+                    REQUIRE(result.status == expected.status);
+                    REQUIRE(result.output == expected.output);
+                }
+            }
+        }
+    }
+}
+
+TEST_CASE("Booleans may be bound, other values may not") {
+    Interpreter interpreter;
+    auto prepared = interpreter.Prepare("(and ?a ?b)");
+    std::string output;
+    interpreter.Execute(*prepared, std::vector<AST>{MakeBoolean(true), MakeNumber(5)}, &output);
+    REQUIRE(output == "5");
+    interpreter.Execute(*prepared, std::vector<AST>{MakeBoolean(false), MakeNumber(5)}, &output);
+    REQUIRE(output == "#f");
+
+    REQUIRE_THROWS_AS(interpreter.Execute(*prepared, {1}), RuntimeError);
+    REQUIRE_THROWS_AS(interpreter.Execute(*prepared, {1, 2, 3}), RuntimeError);
+    std::vector<AST> list = {interpreter.Prepare("(+ 1 2)")->GetAst(), MakeNumber(1)};
+    REQUIRE_THROWS_WITH(interpreter.Execute(*prepared, list, &output),
+                        "Runtime error: slot values must be numbers or booleans");
+}
+
+TEST_CASE("Executing does not read again and obeys the limits") {
+    Interpreter interpreter({.metrics = true, .limits = {.max_steps = 100}});
+    auto prepared = interpreter.Prepare("(+ ?a (* ?b 2))");
+    for (int64_t i = 0; i < 100; ++i) {
+        REQUIRE(interpreter.Execute(*prepared, {i, i}) == std::to_string(3 * i));
+    }
+    Metrics metrics = interpreter.GetMetrics();
+    REQUIRE(metrics.GetStageLatency(Stage::kRead).GetCount() == 1);
+    REQUIRE(metrics.GetStageLatency(Stage::kEvaluate).GetCount() == 100);
+
+    std::string deep;
+    for (int i = 0; i < 200; ++i) {
+        deep += "(+ ?a ";
+    }
+    deep += "0" + std::string(200, ')');
+    auto long_running = interpreter.Prepare(deep);
+    REQUIRE_THROWS_AS(interpreter.Execute(*long_running, {1}), LimitError);
+}
+
+// The prepared constants are hash-consed, so any left referenced by a dead
+// arena cell stay in the table; LSan reports them as leaked too.
+TEST_CASE("Executing in an arena leaves no reference to the constants") {
+    const std::string kTemplates[] = {
+        "(cons '(1 2 3) ?a)",
+        "(list '(5 (6)) (car '((7 8))) ?a)",
+        "((car '(cons)) '(1 2) ?a)",
+        "(list-tail '(9 10 11) ?a)",
+    };
+    size_t before = ConsTable::GetSize();
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        Interpreter interpreter({.mode = mode, .use_arena = true, .hash_cons = true});
+        for (const std::string& text : kTemplates) {
+            INFO(text);
+            auto prepared = interpreter.Prepare(text);
+            std::string expected = Interpreter().Run(Substitute(text, {"1"}));
+            for (int i = 0; i < 3; ++i) {
+                REQUIRE(interpreter.Execute(*prepared, {1}) == expected);
+            }
+        }
+    }
+    REQUIRE(ConsTable::GetSize() == before);
+}
+
+TEST_CASE("A prepared expression is shared between threads") {
+    auto prepared = Interpreter().Prepare("(max (+ ?a 3) ?b (car '(?a)))");
+    std::vector<std::thread> threads;
+    // One flag per thread, not std::vector<bool> whose elements share words.
+    std::vector<char> correct(4, true);
+    for (size_t t = 0; t < correct.size(); ++t) {
+        threads.emplace_back([&, t] {
+            Interpreter interpreter({.use_arena = t % 2 == 1});
+            for (int64_t i = 0; i < 2000; ++i) {
+                int64_t a = i * static_cast<int64_t>(t + 1);
+                std::string output = interpreter.Execute(*prepared, {a, 1000});
+                if (output != std::to_string(std::max(a + 3, int64_t{1000}))) {
+                    correct[t] = false;
+                }
+            }
+        });
+    }
+    for (std::thread& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(correct == std::vector<char>(4, true));
+}
@@ -0,0 +1,104 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+
+#include <sstream>
+
+static AST Parse(std::string_view text) {
+    Tokenizer tokenizer{text};
+    return Read(&tokenizer);
+}
+
+TEST_CASE("Print writes the same text as Run") {
+    const char* texts[] = {"()", "1", "-42", "#t", "foo", "(1 2 3)", "(1 . 2)", "(1 2 . 3)",
+                           "(() (()) ((1)))", "'a", "'(1 'b)", "(a . (b . (c)))",
+                           "99999999999999999999", "((1 . 2) . (3 . 4))"};
+    const char* expected[] = {"()", "1", "-42", "#t", "foo", "(1 2 3)", "(1 . 2)", "(1 2 . 3)",
+                              "(() (()) ((1)))", "(quote a)", "(quote (1 (quote b)))",
+                              "(a b c)", "99999999999999999999",
+                              "((1 . 2) 3 . 4)"};
+    for (size_t i = 0; i < std::size(texts); ++i) {
+        INFO(texts[i]);
+        AST ast = Parse(texts[i]);
+        std::string output = "> ";
+        REQUIRE(Print(ast, &output));
+        REQUIRE(output == std::string("> ") + expected[i]);
+        std::ostringstream stream;
+        REQUIRE(Print(ast, &stream));
+        REQUIRE(stream.str() == expected[i]);
+        REQUIRE(AsString(ast) == expected[i]);
+    }
+}
+
+TEST_CASE("Print walks deep values without native recursion") {
+    const size_t depth = 1000000;
+    AST ast;
+    for (size_t i = 0; i < depth; ++i) {
+        ast = MakeCell(std::move(ast), nullptr);
+    }
+    std::string output;
+    REQUIRE(Print(ast, &output));
+    REQUIRE(output.size() == 2 * depth + 2);
+    REQUIRE(output.find("()") == depth);
+    REQUIRE(output.find_first_not_of('(') == depth + 1);
+    REQUIRE(output.find_first_not_of(')', depth + 1) == std::string::npos);
+}
+
+TEST_CASE("Print truncates at the size cap") {
+    AST ast = Parse("(1 22 333 (4444))");
+    std::string output;
+    REQUIRE(!Print(ast, &output, {.max_size = 6}));
+    REQUIRE(output == "(1 22 ...");
+    output.clear();
+    REQUIRE(Print(ast, &output, {.max_size = 17}));
+    REQUIRE(output == "(1 22 333 (4444))");
+    std::ostringstream stream;
+    REQUIRE(!Print(ast, &stream, {.max_size = 1}));
+    REQUIRE(stream.str() == "(...");
+}
+
+TEST_CASE("Print elides lists nested past the depth cap") {
+    AST ast = Parse("(1 (2 (3)) '(4) 5)");
+    std::string output;
+    REQUIRE(!Print(ast, &output, {.max_depth = 1}));
+    REQUIRE(output == "(1 ... ... 5)");
+    output.clear();
+    REQUIRE(!Print(ast, &output, {.max_depth = 2}));
+    REQUIRE(output == "(1 (2 ...) (quote ...) 5)");
+    output.clear();
+    REQUIRE(Print(ast, &output, {.max_depth = 3}));
+    REQUIRE(output == "(1 (2 (3)) (quote (4)) 5)");
+    output.clear();
+    REQUIRE(Print(Parse("7"), &output, {.max_depth = 1}));
+    REQUIRE(output == "7");
+}
+
+TEST_CASE("Run writes into a caller-owned buffer") {
+    Interpreter interpreter;
+    std::string output;
+    output.reserve(256);
+    const char* data = output.data();
+    interpreter.Run("(list 1 2 3)", &output);
+    REQUIRE(output == "(1 2 3)");
+    interpreter.Run("(+ 1 2)", &output);
+    REQUIRE(output == "3");
+    REQUIRE(output.data() == data);
+
+    REQUIRE_THROWS_AS(interpreter.Run("(car '())", &output), RuntimeError);
+    REQUIRE(output == "3");
+
+    Interpreter cached({.cache_bytes = 1 << 20});
+    for (int i = 0; i < 2; ++i) {
+        cached.Run("'(a b)", &output);
+        REQUIRE(output == "(a b)");
+        REQUIRE(output.data() == data);
+        REQUIRE_THROWS_AS(cached.Run("(car '())", &output), RuntimeError);
+    }
+    REQUIRE(cached.GetCacheStats().hits == 2);
+}
+
+TEST_CASE("Interpreter options cap the printed result") {
+    Interpreter interpreter({.print = {.max_size = 12, .max_depth = 2}});
+    REQUIRE(interpreter.Run("'(1 (2 (3)))") == "(1 (2 ...))");
+    REQUIRE(interpreter.Run("'(1 2 3 4 5 6 7)") == "(1 2 3 4 5 6...");
+}
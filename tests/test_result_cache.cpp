@@ -0,0 +1,93 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+
+using Status = BatchResult::Status;
+
+static size_t Cost(const std::string& key, const std::string& output) {
+    return ResultCache::kEntryOverhead + key.size() + output.size();
+}
+
+TEST_CASE("ResultCache evicts the least recently used entry") {
+    ResultCache cache(3 * Cost("k1", "v1"));
+    cache.Insert("k1", {Status::kOk, "v1"});
+    cache.Insert("k2", {Status::kOk, "v2"});
+    cache.Insert("k3", {Status::kRuntimeError, "e3"});
+    REQUIRE(cache.Find("k1")->output == "v1");
+
+    cache.Insert("k4", {Status::kOk, "v4"});
+    REQUIRE(cache.Find("k2") == nullptr);
+    REQUIRE(cache.Find("k1") != nullptr);
+    REQUIRE(cache.Find("k3")->status == Status::kRuntimeError);
+    REQUIRE(cache.Find("k4") != nullptr);
+
+    const CacheStats& stats = cache.GetStats();
+    REQUIRE(stats.hits == 4);
+    REQUIRE(stats.misses == 1);
+    REQUIRE(stats.evictions == 1);
+    REQUIRE(stats.entries == 3);
+    REQUIRE(stats.bytes == 3 * Cost("k1", "v1"));
+
+    // Too large for the whole budget: stored nowhere, evicts nothing.
+    cache.Insert("big", {Status::kOk, std::string(1000, 'x')});
+    REQUIRE(cache.Find("big") == nullptr);
+    REQUIRE(stats.entries == 3);
+}
+
+TEST_CASE("Run answers repeated expressions from the cache") {
+    for (bool use_arena : {false, true}) {
+        Interpreter interpreter({.use_arena = use_arena, .cache_bytes = 1 << 20});
+        REQUIRE(interpreter.Run("(+ 1 (* 2 3))") == "7");
+        REQUIRE(interpreter.Run("  ( +  1\n(* 2   3) ) ") == "7");
+        REQUIRE(interpreter.Run("(car '(a b))") == "a");
+        REQUIRE(interpreter.Run("(car (quote (a b)))") == "a");
+        REQUIRE(interpreter.Run("(car '(b a))") == "b");
+
+        const CacheStats& stats = interpreter.GetCacheStats();
+        REQUIRE(stats.hits == 2);
+        REQUIRE(stats.misses == 3);
+        REQUIRE(stats.entries == 3);
+    }
+}
+
+TEST_CASE("Errors are cached with their class and message") {
+    Interpreter interpreter({.cache_bytes = 1 << 20});
+    std::string message;
+    try {
+        interpreter.Run("(car '())");
+    } catch (const RuntimeError& error) {
+        message = error.what();
+    }
+    REQUIRE(!message.empty());
+    try {
+        interpreter.Run("(car (quote ()))");
+        FAIL("expected RuntimeError");
+    } catch (const RuntimeError& error) {
+        REQUIRE(error.what() == message);
+    }
+    REQUIRE(interpreter.GetCacheStats().hits == 1);
+
+    // Input that does not parse has no key and is never cached.
+    REQUIRE_THROWS_AS(interpreter.Run("(+ 1"), SyntaxError);
+    REQUIRE_THROWS_AS(interpreter.Run("1 2"), SyntaxError);
+    REQUIRE(interpreter.GetCacheStats().misses == 1);
+    REQUIRE(interpreter.GetCacheStats().entries == 1);
+}
+
+TEST_CASE("The cache stays within its budget") {
+    Interpreter interpreter({.cache_bytes = 4096});
+    for (int i = 0; i < 1000; ++i) {
+        REQUIRE(interpreter.Run("(+ " + std::to_string(i) + " 1)") == std::to_string(i + 1));
+    }
+    const CacheStats& stats = interpreter.GetCacheStats();
+    REQUIRE(stats.bytes <= 4096);
+    REQUIRE(stats.evictions == 1000 - stats.entries);
+    REQUIRE(interpreter.Run("(+ 999 1)") == "1000");
+    REQUIRE(stats.hits == 1);
+
+    Interpreter disabled;
+    disabled.Run("(+ 1 2)");
+    disabled.Run("(+ 1 2)");
+    REQUIRE(disabled.GetCacheStats().hits == 0);
+    REQUIRE(disabled.GetCacheStats().misses == 0);
+}
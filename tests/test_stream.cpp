@@ -0,0 +1,110 @@
+#include <catch.hpp>
+
+#include "scheme.h"
+
+#include <sstream>
+
+#include <unistd.h>
+
+using Status = BatchResult::Status;
+
+static std::vector<BatchResult> RunStream(Interpreter* interpreter, InputSource* source) {
+    std::vector<BatchResult> results;
+    size_t count = interpreter->RunStream(source, [&](const BatchResult& result) {
+        results.push_back(result);
+    });
+    REQUIRE(count == results.size());
+    return results;
+}
+
+static std::vector<BatchResult> RunStream(const std::string& input, InterpreterOptions options = {}) {
+    Interpreter interpreter(options);
+    StringSource source(input);
+    return RunStream(&interpreter, &source);
+}
+
+static void RequireResults(const std::vector<BatchResult>& results,
+                           const std::vector<std::pair<Status, std::string>>& expected) {
+    REQUIRE(results.size() == expected.size());
+    for (size_t i = 0; i < expected.size(); ++i) {
+        INFO(i);
+        REQUIRE(results[i].status == expected[i].first);
+        if (expected[i].first == Status::kOk) {
+            REQUIRE(results[i].output == expected[i].second);
+        }
+    }
+}
+
+TEST_CASE("Every top-level form of a stream is evaluated") {
+    for (bool use_arena : {false, true}) {
+        for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+            auto results = RunStream("(+ 1 2) 42 '(a . b)\n#t\n(list 1 2)(car '(x))",
+                                     {.mode = mode, .use_arena = use_arena});
+            RequireResults(results, {{Status::kOk, "3"},
+                                     {Status::kOk, "42"},
+                                     {Status::kOk, "(a . b)"},
+                                     {Status::kOk, "#t"},
+                                     {Status::kOk, "(1 2)"},
+                                     {Status::kOk, "x"}});
+        }
+    }
+    REQUIRE(RunStream("").empty());
+    REQUIRE(RunStream("  \n ").empty());
+}
+
+TEST_CASE("Errors are reported per form and the stream goes on") {
+    RequireResults(RunStream("(car '()) (+ 1 2)"),
+                   {{Status::kRuntimeError, ""}, {Status::kOk, "3"}});
+    RequireResults(RunStream(") 1"), {{Status::kSyntaxError, ""}, {Status::kOk, "1"}});
+    RequireResults(RunStream("(1 . 2 3 (4)) 5"), {{Status::kSyntaxError, ""}, {Status::kOk, "5"}});
+    RequireResults(RunStream("(quote 1 2) (quote 3)"),
+                   {{Status::kSyntaxError, ""}, {Status::kOk, "3"}});
+    RequireResults(RunStream("(+ 1 (. 2)) '7"), {{Status::kSyntaxError, ""}, {Status::kOk, "7"}});
+    RequireResults(RunStream("'(1 99999999999999999999 (2)) 8"),
+                   {{Status::kOk, "(1 99999999999999999999 (2))"}, {Status::kOk, "8"}});
+    RequireResults(RunStream("(+ 1 2))(- 5 1)"),
+                   {{Status::kOk, "3"}, {Status::kSyntaxError, ""}, {Status::kOk, "4"}});
+    RequireResults(RunStream("1 99999999999999999999999 (+ 2 3)"),
+                   {{Status::kOk, "1"}, {Status::kOk, "99999999999999999999999"}, {Status::kOk, "5"}});
+    RequireResults(RunStream("1 (+ 1 (+ 2"), {{Status::kOk, "1"}, {Status::kSyntaxError, ""}});
+}
+
+TEST_CASE("Streams are read incrementally from any source") {
+    std::string input;
+    std::vector<std::pair<Status, std::string>> expected;
+    for (int i = 0; i < 2000; ++i) {
+        input += "(+ " + std::to_string(i) + " 1)\n";
+        expected.push_back({Status::kOk, std::to_string(i + 1)});
+        if (i % 100 == 0) {
+            input += "(list-tail '(1 2) 5) (. b)\n";
+            expected.push_back({Status::kRuntimeError, ""});
+            expected.push_back({Status::kSyntaxError, ""});
+        }
+    }
+
+    Interpreter interpreter({.use_arena = true});
+    SECTION("istream") {
+        std::stringstream ss{input};
+        StreamSource source(&ss, 7);
+        RequireResults(RunStream(&interpreter, &source), expected);
+    }
+    SECTION("pipe") {
+        int fds[2];
+        REQUIRE(pipe(fds) == 0);
+        // Small enough to fit in the pipe buffer, so one thread can write it up front.
+        std::string head = input.substr(0, 4096);
+        REQUIRE(write(fds[1], head.data(), head.size()) == ssize_t(head.size()));
+        close(fds[1]);
+        FdSource source(fds[0], 5);
+        StringSource expected_source(head);
+        Interpreter reference;
+        auto results = RunStream(&interpreter, &source);
+        auto reference_results = RunStream(&reference, &expected_source);
+        REQUIRE(results.size() == reference_results.size());
+        for (size_t i = 0; i < results.size(); ++i) {
+            REQUIRE(results[i].status == reference_results[i].status);
+            REQUIRE(results[i].output == reference_results[i].output);
+        }
+        close(fds[0]);
+    }
+}
@@ -0,0 +1,53 @@
+#include <catch.hpp>
+
+#include "builtins.h"
+#include "symbol_table.h"
+
+static AST Parse(const std::string& expr) {
+    Tokenizer tokenizer{std::string_view(expr)};
+    return Read(&tokenizer);
+}
+
+TEST_CASE("A name is interned once") {
+    Symbol* symbol = SymbolTable::Intern("test-symbols-name");
+    REQUIRE(SymbolTable::Intern("test-symbols-name") == symbol);
+    REQUIRE(SymbolTable::Intern(std::string("test-symbols-") + "name") == symbol);
+    REQUIRE(SymbolTable::Find("test-symbols-name") == symbol);
+    REQUIRE(symbol->GetName() == "test-symbols-name");
+
+    Symbol* other = SymbolTable::Intern("test-symbols-other");
+    REQUIRE(other != symbol);
+    REQUIRE(other->GetId() != symbol->GetId());
+
+    REQUIRE(SymbolTable::Find("test-symbols-never-interned") == nullptr);
+}
+
+TEST_CASE("The parser makes interned symbols") {
+    AST parsed = Parse("test-symbols-parsed");
+    REQUIRE(Is<Symbol>(parsed));
+    REQUIRE(As<Symbol>(parsed) == SymbolTable::Find("test-symbols-parsed"));
+    REQUIRE(As<Symbol>(As<Cell>(Parse("(test-symbols-parsed)"))->GetFirst()) ==
+            As<Symbol>(parsed));
+}
+
+TEST_CASE("Builtin names resolve to their own slot") {
+    REQUIRE(GetBuiltinCount() > 0);
+    for (uint32_t id = 0; id < GetBuiltinCount(); ++id) {
+        const Builtin& builtin = GetBuiltin(id);
+        INFO(builtin.name);
+        Symbol* symbol = SymbolTable::Intern(builtin.name);
+        REQUIRE(symbol->GetId() == id);
+        REQUIRE(SymbolTable::Find(builtin.name) == symbol);
+        REQUIRE(FindBuiltin(*symbol) == &builtin);
+        REQUIRE(GetBuiltinId(&builtin) == id);
+    }
+}
+
+TEST_CASE("Other symbols resolve to no builtin") {
+    for (const char* name : {"test-symbols-unknown", "car2", "Car", "+1"}) {
+        INFO(name);
+        Symbol* symbol = SymbolTable::Intern(name);
+        REQUIRE(symbol->GetId() >= GetBuiltinCount());
+        REQUIRE(FindBuiltin(*symbol) == nullptr);
+    }
+}
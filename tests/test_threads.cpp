@@ -0,0 +1,68 @@
+#include <catch.hpp>
+
+#include "applier.h"
+#include "scheme.h"
+
+#include <atomic>
+#include <thread>
+
+static constexpr size_t kThreads = 8;
+
+static const std::vector<std::pair<std::string, std::string>> kCases = {
+    {"(+ 1 (* 2 3))", "7"},
+    {"(and (< 1 2 3) (or #f (= 4 4)))", "#t"},
+    {"(list-ref (cons 0 '(1 2 3)) 2)", "2"},
+    {"'(1 (2 fresh-symbol) . 3)", "(1 (2 fresh-symbol) . 3)"},
+    {"(cdr '(a b c))", "(b c)"},
+    {"(max (abs -7) (min 8 9))", "8"}};
+
+TEST_CASE("Separate interpreters run concurrently") {
+    for (EvalMode mode : {EvalMode::kBytecode, EvalMode::kTreeWalk}) {
+        for (bool use_arena : {false, true}) {
+            std::atomic<size_t> mismatches = 0;
+            std::vector<std::thread> threads;
+            for (size_t t = 0; t < kThreads; ++t) {
+                threads.emplace_back([&, t] {
+                    Interpreter interpreter({.mode = mode, .use_arena = use_arena});
+                    for (size_t i = 0; i < 500; ++i) {
+                        const auto& [expr, expected] = kCases[(i + t) % kCases.size()];
+                        if (interpreter.Run(expr) != expected) {
+                            ++mismatches;
+                        }
+                        // New symbols are interned while other threads read the table.
+                        std::string symbol = "s" + std::to_string(t) + "-" + std::to_string(i);
+                        if (interpreter.Run("'" + symbol) != symbol) {
+                            ++mismatches;
+                        }
+                        try {
+                            interpreter.Run("(car '())");
+                            ++mismatches;
+                        } catch (const RuntimeError&) {
+                        }
+                    }
+                });
+            }
+            for (auto& thread : threads) {
+                thread.join();
+            }
+            REQUIRE(mismatches == 0);
+        }
+    }
+}
+
+TEST_CASE("Builtins are resolved concurrently") {
+    std::atomic<size_t> found = 0;
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < kThreads; ++t) {
+        threads.emplace_back([&] {
+            if (Applier::Resolve("list-tail") && Applier::Resolve("+")) {
+                ++found;
+            }
+        });
+    }
+    for (auto& thread : threads) {
+        thread.join();
+    }
+    REQUIRE(found == kThreads);
+    REQUIRE_THROWS_AS(Applier::Resolve("no-such-builtin"), RuntimeError);
+}
@@ -0,0 +1,123 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <utility>
+
+// Each worker starts with this many ranges, small enough for stealing to even out the load.
+static constexpr size_t kRangesPerWorker = 8;
+
+ThreadPool::ThreadPool(size_t threads) {
+    if (threads == 0) {
+        threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        queues_.push_back(std::make_unique<Queue>());
+    }
+    for (size_t i = 0; i < threads; ++i) {
+        threads_.emplace_back([this, i] { WorkerLoop(i); });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard lock(mutex_);
+        stopping_ = true;
+    }
+    wake_.notify_all();
+    for (auto& thread : threads_) {
+        thread.join();
+    }
+}
+
+size_t ThreadPool::GetThreadCount() const {
+    return threads_.size();
+}
+
+void ThreadPool::ParallelFor(size_t count, const Body& body) {
+    if (count == 0) {
+        return;
+    }
+    {
+        std::lock_guard lock(mutex_);
+        body_ = &body;
+        remaining_ = count;
+        error_ = nullptr;
+    }
+    size_t chunk = std::max<size_t>(1, count / (queues_.size() * kRangesPerWorker));
+    size_t worker = 0;
+    for (size_t begin = 0; begin < count; begin += chunk) {
+        std::lock_guard lock(queues_[worker]->mutex);
+        queues_[worker]->ranges.push_back({begin, std::min(begin + chunk, count)});
+        worker = (worker + 1) % queues_.size();
+    }
+
+    std::unique_lock lock(mutex_);
+    ++generation_;
+    wake_.notify_all();
+    done_.wait(lock, [this] { return remaining_ == 0; });
+    body_ = nullptr;
+    if (auto error = std::exchange(error_, nullptr)) {
+        std::rethrow_exception(error);
+    }
+}
+
+void ThreadPool::WorkerLoop(size_t worker) {
+    size_t seen_generation = 0;
+    while (true) {
+        {
+            std::unique_lock lock(mutex_);
+            wake_.wait(lock, [&] { return stopping_ || generation_ != seen_generation; });
+            if (stopping_) {
+                return;
+            }
+            seen_generation = generation_;
+        }
+        Range range;
+        while (TakeRange(worker, &range)) {
+            Execute(worker, range);
+        }
+    }
+}
+
+bool ThreadPool::TakeRange(size_t worker, Range* range) {
+    {
+        Queue& own = *queues_[worker];
+        std::lock_guard lock(own.mutex);
+        if (!own.ranges.empty()) {
+            *range = own.ranges.back();
+            own.ranges.pop_back();
+            return true;
+        }
+    }
+    for (size_t offset = 1; offset < queues_.size(); ++offset) {
+        Queue& victim = *queues_[(worker + offset) % queues_.size()];
+        std::lock_guard lock(victim.mutex);
+        if (!victim.ranges.empty()) {
+            *range = victim.ranges.front();
+            victim.ranges.pop_front();
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::Execute(size_t worker, Range range) {
+    std::exception_ptr error;
+    for (size_t index = range.begin; index < range.end; ++index) {
+        try {
+            (*body_)(worker, index);
+        } catch (...) {
+            if (!error) {
+                error = std::current_exception();
+            }
+        }
+    }
+    std::lock_guard lock(mutex_);
+    if (error && !error_) {
+        error_ = error;
+    }
+    remaining_ -= range.end - range.begin;
+    if (remaining_ == 0) {
+        done_.notify_all();
+    }
+}
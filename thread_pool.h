@@ -0,0 +1,63 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads for data-parallel loops. Each worker owns a
+// deque of index ranges: it takes work from the back of its own deque and,
+// once that is empty, steals from the front of the others, so uneven items
+// balance out without a shared queue.
+class ThreadPool {
+public:
+    using Body = std::function<void(size_t worker, size_t index)>;
+
+    // Zero threads means one per hardware thread.
+    explicit ThreadPool(size_t threads = 0);
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t GetThreadCount() const;
+
+    // Calls body(worker, index) for every index in [0, count) and returns once
+    // all calls are done. `worker` is below GetThreadCount() and identifies the
+    // calling thread, so per-worker state needs no locking. The first exception
+    // thrown by body is rethrown here after the loop drains.
+    // Must not be called concurrently or from inside a body.
+    void ParallelFor(size_t count, const Body& body);
+
+private:
+    struct Range {
+        size_t begin;
+        size_t end;
+    };
+
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+    };
+
+    void WorkerLoop(size_t worker);
+    bool TakeRange(size_t worker, Range* range);
+    void Execute(size_t worker, Range range);
+
+    std::vector<std::unique_ptr<Queue>> queues_;
+    std::vector<std::thread> threads_;
+
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    size_t generation_ = 0;
+    size_t remaining_ = 0;
+    bool stopping_ = false;
+    const Body* body_ = nullptr;
+    std::exception_ptr error_;
+};
@@ -2,7 +2,7 @@
 #include "error.h"
 #include "lexeme_types.cpp"
 
-#include <sstream>
+#include <limits>
 
 bool SymbolToken::operator==(const SymbolToken& other) const {
     return name == other.name;
@@ -17,97 +17,138 @@ bool DotToken::operator==(const DotToken&) const {
 }
 
 bool ConstantToken::operator==(const ConstantToken& other) const {
-    return value == other.value;
+    return value == other.value && big == other.big;
 }
 
 bool BooleanToken::operator==(const BooleanToken& other) const {
     return value == other.value;
 }
 
-Tokenizer::Tokenizer(std::istream* is) : is_(is) {
+Tokenizer::Tokenizer(std::istream* is)
+    : owned_source_(std::make_unique<StreamSource>(is)), source_(owned_source_.get()) {
     Next();
 }
 
-bool Tokenizer::IsEnd() {
-    char sym;
+Tokenizer::Tokenizer(std::string_view input)
+    : owned_source_(std::make_unique<StringSource>(input)), source_(owned_source_.get()) {
+    Next();
+}
 
-    auto get_symbol = [&]() -> bool {
-        sym = is_->get();
-        return sym != EOF;
-    };
+Tokenizer::Tokenizer(InputSource* source) : source_(source) {
+    Next();
+}
 
-    auto peek_symbol = [&]() -> bool {
-        sym = is_->peek();
-        return sym != EOF;
-    };
+bool Tokenizer::Peek(char* sym) {
+    while (position_ == chunk_.size()) {
+        chunk_ = source_->NextChunk();
+        position_ = 0;
+        if (chunk_.empty()) {
+            return false;
+        }
+    }
+    *sym = chunk_[position_];
+    return true;
+}
 
-    while (peek_symbol()) {
-        if (LexemeTypes::IsSkip(sym)) {
-            get_symbol();
-            continue;
+ConstantToken Tokenizer::ReadInteger(bool negative) {
+    // The magnitude is accumulated unsigned so that the minimum int64_t fits.
+    uint64_t limit = negative ? uint64_t{1} << 63 : std::numeric_limits<int64_t>::max();
+    uint64_t value = 0;
+    const char* chunk = chunk_.data();
+    size_t start = position_;
+    char sym;
+    while (Peek(&sym) && LexemeTypes::IsDigit(sym)) {
+        uint64_t digit = sym - '0';
+        if (value > (limit - digit) / 10) {
+            // Only a literal that overflows keeps its text, which the parser
+            // makes big. Like a symbol it points into a persistent input if it
+            // lies in one chunk, together with its minus sign.
+            size_t end = position_;
+            while (end < chunk_.size() && LexemeTypes::IsDigit(chunk_[end])) {
+                ++end;
+            }
+            if (chunk_.data() == chunk && end < chunk_.size() && source_->IsPersistent() &&
+                (!negative || start > 0)) {
+                position_ = end;
+                return ConstantToken{0, chunk_.substr(start - negative, end - start + negative)};
+            }
+            scratch_ = (negative ? "-" : "") + std::to_string(value);
+            while (Peek(&sym) && LexemeTypes::IsDigit(sym)) {
+                ++position_;
+                scratch_ += sym;
+            }
+            return ConstantToken{0, TokenText::Transient(scratch_)};
         }
-        break;
+        ++position_;
+        value = value * 10 + digit;
     }
+    return ConstantToken{negative ? static_cast<int64_t>(0 - value) : static_cast<int64_t>(value)};
+}
 
+TokenText Tokenizer::ReadSymbol() {
+    size_t start = position_++;
+    while (position_ < chunk_.size() && LexemeTypes::IsInnerSymbol(chunk_[position_])) {
+        ++position_;
+    }
+    if (position_ < chunk_.size() && source_->IsPersistent()) {
+        return chunk_.substr(start, position_ - start);
+    }
+    // The symbol may continue in the next chunk, or the chunk dies with it.
+    scratch_.assign(chunk_.substr(start, position_ - start));
+    char sym;
+    while (Peek(&sym) && LexemeTypes::IsInnerSymbol(sym)) {
+        ++position_;
+        scratch_ += sym;
+    }
+    return TokenText::Transient(scratch_);
+}
+
+bool Tokenizer::IsEnd() {
+    char sym;
+    while (Peek(&sym) && LexemeTypes::IsSkip(sym)) {
+        ++position_;
+    }
     return !current_token_.has_value();
 }
 
 void Tokenizer::Next() {
+    if (current_token_.has_value()) {
+        if (auto bracket_token = std::get_if<BracketToken>(&*current_token_)) {
+            bracket_balance_ += *bracket_token == BracketToken::OPEN ? 1 : -1;
+        }
+    }
     current_token_.reset();
+    Scan();
+}
 
+void Tokenizer::Scan() {
     char sym;
-
-    auto get_symbol = [&]() -> bool {
-        sym = is_->get();
-        return sym != EOF;
-    };
-
-    auto peek_symbol = [&]() -> bool {
-        sym = is_->peek();
-        return sym != EOF;
-    };
-
-    while (get_symbol()) {
-        if (LexemeTypes::IsSkip(sym)) {
-            continue;
-        }
-        if (LexemeTypes::IsPlus(sym) || LexemeTypes::IsMinus(sym)) {
-            std::string str;
-            str += sym;
-            while (peek_symbol() && LexemeTypes::IsDigit(sym)) {
-                get_symbol();
-                str += sym;
-            }
-            if (str.size() == 1) {
-                current_token_ = Token{SymbolToken{str}};
-            } else {
-                current_token_ = Token{ConstantToken{std::stoi(str)}};
-            }
-            break;
-        }
+    while (Peek(&sym)) {
         if (LexemeTypes::IsDigit(sym)) {
-            std::string str;
-            str += sym;
-            while (peek_symbol() && LexemeTypes::IsDigit(sym)) {
-                get_symbol();
-                str += sym;
-            }
-            current_token_ = Token{ConstantToken{std::stoi(str)}};
-            break;
+            current_token_ = Token{ReadInteger(false)};
+            return;
         }
         if (LexemeTypes::IsStartSymbol(sym)) {
-            std::string str;
-            str += sym;
-            while (peek_symbol() && LexemeTypes::IsInnerSymbol(sym)) {
-                get_symbol();
-                str += sym;
-            }
-            if (str == "#t") {
+            TokenText name = ReadSymbol();
+            if (name == "#t") {
                 current_token_ = Token{BooleanToken{true}};
-            } else if (str == "#f") {
+            } else if (name == "#f") {
                 current_token_ = Token{BooleanToken{false}};
             } else {
-                current_token_ = Token{SymbolToken{str}};
+                current_token_ = Token{SymbolToken{std::move(name)}};
+            }
+            return;
+        }
+        ++position_;
+        if (LexemeTypes::IsSkip(sym)) {
+            continue;
+        }
+        if (LexemeTypes::IsPlus(sym) || LexemeTypes::IsMinus(sym)) {
+            char next;
+            if (Peek(&next) && LexemeTypes::IsDigit(next)) {
+                current_token_ = Token{ReadInteger(LexemeTypes::IsMinus(sym))};
+            } else {
+                current_token_ = Token{SymbolToken{LexemeTypes::IsPlus(sym) ? "+" : "-"}};
             }
             return;
         }
@@ -126,20 +167,24 @@ void Tokenizer::Next() {
     }
 }
 
-Token Tokenizer::GetToken() {
+const Token& Tokenizer::GetToken() {
     if (!current_token_.has_value()) {
         throw SyntaxError("Syntax error: token not found");
     }
-    return current_token_.value();
+    return *current_token_;
 }
 
-std::vector<Token> Read(const std::string& stream) {
-    std::stringstream is(stream);
-    Tokenizer tokenizer(&is);
+std::vector<Token> Read(std::string_view stream) {
+    Tokenizer tokenizer(stream);
 
     std::vector<Token> output;
     while (!tokenizer.IsEnd()) {
         output.push_back(tokenizer.GetToken());
+        if (auto symbol_token = std::get_if<SymbolToken>(&output.back())) {
+            symbol_token->name.Own();
+        } else if (auto constant_token = std::get_if<ConstantToken>(&output.back())) {
+            constant_token->big.Own();
+        }
         tokenizer.Next();
     }
     return output;
@@ -3,11 +3,97 @@
 #include <variant>
 #include <optional>
 #include <istream>
+#include <memory>
+#include <string>
+#include <string_view>
 #include <vector>
 #include <cstdint>
 
+#include "error.h"
+#include "input_source.h"
+
+// The text of a token: a view of characters that outlive it, such as a
+// persistent input or a literal, or a copy of its own. Text in a buffer that
+// the tokenizer reuses is transient: copying it copies the characters.
+class TokenText {
+public:
+    TokenText(const char* text = "") : view_(text) {
+    }
+    TokenText(std::string_view text) : view_(text) {
+    }
+
+    static TokenText Transient(std::string_view text) {
+        TokenText result{text};
+        result.transient_ = true;
+        return result;
+    }
+
+    TokenText(const TokenText& other) {
+        *this = other;
+    }
+    TokenText(TokenText&& other) noexcept {
+        *this = std::move(other);
+    }
+    TokenText& operator=(const TokenText& other) {
+        if (other.IsOwned() || other.transient_) {
+            copy_.assign(other.view_);
+            view_ = copy_;
+        } else {
+            copy_.clear();
+            view_ = other.view_;
+        }
+        transient_ = false;
+        return *this;
+    }
+    TokenText& operator=(TokenText&& other) noexcept {
+        if (other.IsOwned()) {
+            // A move may relocate the characters of a short string.
+            copy_ = std::move(other.copy_);
+            view_ = copy_;
+        } else {
+            copy_.clear();
+            view_ = other.view_;
+        }
+        transient_ = other.transient_;
+        return *this;
+    }
+
+    operator std::string_view() const {
+        return view_;
+    }
+
+    bool empty() const {
+        return view_.empty();
+    }
+
+    // Replaces a view with a copy, so the text no longer depends on the input.
+    void Own() {
+        if (!IsOwned()) {
+            copy_.assign(view_);
+            view_ = copy_;
+            transient_ = false;
+        }
+    }
+
+    friend bool operator==(const TokenText& lhs, std::string_view rhs) {
+        return lhs.view_ == rhs;
+    }
+
+private:
+    bool IsOwned() const {
+        return !copy_.empty();
+    }
+
+    // Empty unless the text is owned.
+    std::string copy_;
+    std::string_view view_;
+    bool transient_ = false;
+};
+
 struct SymbolToken {
-    std::string name;
+    // Points into the input when the source is persistent, otherwise into the
+    // tokenizer until the token is copied.
+    TokenText name;
 
     bool operator==(const SymbolToken& other) const;
 };
@@ -24,6 +110,9 @@ enum class BracketToken { OPEN, CLOSE };
 
 struct ConstantToken {
     int64_t value;
+    // Instead of `value`, the text of a literal outside the int64_t range,
+    // sign included. Points into the input like SymbolToken::name.
+    TokenText big = {};
 
     bool operator==(const ConstantToken& other) const;
 };
@@ -40,16 +129,46 @@ using Token =
 class Tokenizer {
 public:
     Tokenizer(std::istream* in);
+    // Tokenizes the characters in place, they must outlive the tokenizer.
+    Tokenizer(std::string_view input);
+    // The source must outlive the tokenizer.
+    Tokenizer(InputSource* source);
 
     bool IsEnd();
 
     void Next();
 
-    Token GetToken();
+    // The current token, until the next Next(). A copy of it is valid as long
+    // as the input, or on its own when the source is not persistent.
+    const Token& GetToken();
+
+    // Opening minus closing brackets consumed so far. Lets a caller that gave
+    // up on a malformed datum skip the rest of it.
+    int64_t GetBracketBalance() const {
+        return bracket_balance_;
+    }
 
 private:
-    std::istream* is_;
+    // Stores the next character in `sym` without consuming it, pulling a new
+    // chunk from the source when the current one is exhausted.
+    bool Peek(char* sym);
+
+    // Reads the next token into current_token_, if there is one.
+    void Scan();
+
+    ConstantToken ReadInteger(bool negative);
+    TokenText ReadSymbol();
+
+    std::unique_ptr<InputSource> owned_source_;
+    InputSource* source_;
+    std::string_view chunk_;
+    size_t position_ = 0;
+    // Symbols that cannot point into the input, and integer literals too long
+    // for int64_t, are assembled here.
+    std::string scratch_;
     std::optional<Token> current_token_;
+    int64_t bracket_balance_ = 0;
 };
 
-std::vector<Token> Read(const std::string& stream);
+// The returned tokens own their text, they do not point into `stream`.
+std::vector<Token> Read(std::string_view stream);
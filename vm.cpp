@@ -0,0 +1,150 @@
+#include "vm.h"
+#include "arena.h"
+#include "budget.h"
+#include "builtins.h"
+#include "metrics.h"
+
+static bool IsFalse(const AST& value) {
+    return Is<Boolean>(value) && !value.GetBoolean();
+}
+
+static void CheckNumber(const AST& value, uint32_t builtin) {
+    if (!Is<Number>(value)) {
+        ThrowArgumentType(GetBuiltin(builtin));
+    }
+}
+
+VirtualMachine::VirtualMachine(size_t max_depth) : max_depth_(max_depth) {
+}
+
+AST VirtualMachine::Run(const Program& entry, std::span<const AST> args) {
+    stack_.clear();
+    frames_.clear();
+    const Program* program = &entry;
+    const Instruction* code = program->code.data();
+    size_t size = program->code.size();
+    size_t pc = 0;
+    // Read once, so that a run without metrics only tests a register per call.
+    Metrics* metrics = Metrics::Current();
+    // Steps are counted down in a register; unbounded, the count never runs out.
+    Budget* budget = Budget::Current();
+    uint64_t ticks = budget ? budget->Take() : UINT64_MAX;
+    Arena* arena = Arena::Current();
+    while (true) {
+        if (pc == size) {
+            if (frames_.empty()) {
+                break;
+            }
+            program = frames_.back().caller;
+            pc = frames_.back().return_pc;
+            frames_.pop_back();
+            code = program->code.data();
+            size = program->code.size();
+            continue;
+        }
+        if (ticks-- == 0) [[unlikely]] {
+            ticks = budget->Take() - 1;
+        }
+        const Instruction& instruction = code[pc++];
+        switch (instruction.code) {
+            case OpCode::kPushConstant: {
+                const AST& constant = program->constants[instruction.arg];
+                // A program compiled outside the arena, a prepared one, holds
+                // counted constants; arena cells must not point to them, see Arena.
+                if (arena && constant.IsCounted()) [[unlikely]] {
+                    stack_.push_back(BindSlots(constant, {}, {}));
+                } else {
+                    stack_.push_back(constant);
+                }
+                break;
+            }
+            case OpCode::kCallBuiltin: {
+                std::span<const AST> args(stack_.data() + stack_.size() - instruction.count,
+                                          instruction.count);
+                const Builtin& builtin = GetBuiltin(instruction.arg);
+                CheckArgumentTypes(builtin, args);
+                AST result = metrics ? metrics->CallBuiltin(instruction.arg, args)
+                                     : builtin.kernel(args);
+                stack_.resize(stack_.size() - instruction.count);
+                stack_.push_back(std::move(result));
+                break;
+            }
+            case OpCode::kJumpIfFalse:
+                if (IsFalse(stack_.back())) {
+                    pc = instruction.arg;
+                } else {
+                    stack_.pop_back();
+                }
+                break;
+            case OpCode::kJumpIfTrue:
+                if (!IsFalse(stack_.back())) {
+                    pc = instruction.arg;
+                } else {
+                    stack_.pop_back();
+                }
+                break;
+            case OpCode::kCheckNumber:
+                CheckNumber(stack_.back(), instruction.count);
+                break;
+            case OpCode::kCompare: {
+                AST rhs = std::move(stack_.back());
+                stack_.pop_back();
+                CheckNumber(rhs, instruction.count);
+                if (CompareNumbers(GetBuiltin(instruction.count), stack_.back(), rhs)) {
+                    stack_.back() = std::move(rhs);
+                } else {
+                    stack_.back() = MakeBoolean(false);
+                    pc = instruction.arg;
+                }
+                break;
+            }
+            case OpCode::kPop:
+                stack_.pop_back();
+                break;
+            case OpCode::kPushArgument:
+                stack_.push_back(args[instruction.arg]);
+                break;
+            // Only the entry program has slots, calls compiled on dispatch get them bound.
+            case OpCode::kPushTemplate:
+                stack_.push_back(BindSlots(program->constants[instruction.arg], entry.slots, args));
+                break;
+            case OpCode::kCountCall:
+                if (metrics) {
+                    metrics->CountCall(instruction.arg);
+                }
+                break;
+            case OpCode::kFail:
+                throw RuntimeError(program->messages[instruction.arg]);
+            case OpCode::kDispatch: {
+                AST operation = std::move(stack_.back());
+                stack_.pop_back();
+                if (!Is<Symbol>(operation)) {
+                    throw RuntimeError("Runtime Error: incorrect operation");
+                }
+                const Builtin* builtin = FindBuiltin(*As<Symbol>(operation));
+                if (!builtin) {
+                    throw RuntimeError("Runtime error: unknown command");
+                }
+                if (frames_.size() >= max_depth_) {
+                    throw RuntimeError("Runtime error: maximum nesting depth exceeded");
+                }
+                const AST& operands = program->constants[instruction.arg];
+                auto callee = std::make_unique<Program>(CompileCall(
+                    *builtin, instruction.count ? BindSlots(operands, entry.slots, args) : operands,
+                    max_depth_, metrics != nullptr));
+                frames_.push_back({std::move(callee), program, pc});
+                program = frames_.back().program.get();
+                code = program->code.data();
+                size = program->code.size();
+                pc = 0;
+                break;
+            }
+        }
+    }
+    if (budget) {
+        budget->Return(ticks);
+    }
+    AST result = std::move(stack_.back());
+    stack_.clear();
+    return result;
+}
@@ -0,0 +1,25 @@
+#pragma once
+
+#include "bytecode.h"
+#include <memory>
+
+class VirtualMachine {
+public:
+    explicit VirtualMachine(size_t max_depth = kDefaultMaxDepth);
+
+    // `args` are the values of the program's slots, one per slot.
+    AST Run(const Program& program, std::span<const AST> args = {});
+
+private:
+    // A call whose operator was only known at runtime: its program, compiled
+    // on dispatch, and the position to resume in the caller once it returns.
+    struct Frame {
+        std::unique_ptr<Program> program;
+        const Program* caller;
+        size_t return_pc;
+    };
+
+    size_t max_depth_;
+    std::vector<AST> stack_;
+    std::vector<Frame> frames_;
+};